@@ -14,6 +14,8 @@
 
 //constants
 const int AudioEngine::defaultPolyphony = 1;
+const int AudioEngine::maxPolyphony = 16;
+const int AudioEngine::defaultControlRateChunkSize = 32;
 
 
 
@@ -26,11 +28,15 @@ AudioEngine::AudioEngine(juce::MidiKeyboardState& keyState, juce::MidiMessageCol
     associatedImage = new SegmentableImage(this);
 
     synth.addSound(new TempSound());
+    synth.setMinimumRenderingSubdivisionSize(1, true); //the sub-blocks are already split at MIDI events by getNextAudioBlock, so the synth mustn't merge or re-split them
+    synth.setNumWorkers(getDefaultNumRenderThreads());
 }
 AudioEngine::~AudioEngine()
 {
     DBG("destroying AudioEngine...");
 
+    cancelPendingUpdate();
+
     //associatedImage will be deleted automatically (unique_ptr)
     delete associatedImage;
 
@@ -74,6 +80,7 @@ bool AudioEngine::serialise(juce::XmlElement* xml, juce::Array<juce::MemoryBlock
 }
 bool AudioEngine::serialiseImage(juce::XmlElement* xmlAudioEngine, juce::Array<juce::MemoryBlock>* attachedData)
 {
+    sampleStore.beginSerialisation(); //samples that are used by several regions are only stored once
     //return associatedImage.get()->serialise(xmlAudioEngine, attachedData); //stores image and all its regions;
     return associatedImage->serialise(xmlAudioEngine, attachedData); //stores image and all its regions;
 }
@@ -114,6 +121,9 @@ bool AudioEngine::serialiseVoices(juce::XmlElement* xmlAudioEngine)
 
     bool serialisationSuccessful = true;
     xmlAudioEngine->setAttribute("synth_numVoices", synth.getNumVoices());
+    xmlAudioEngine->setAttribute("maxActiveVoices", voicePool.getMaxActiveVoices());
+    xmlAudioEngine->setAttribute("voiceStealingPolicy", static_cast<int>(voicePool.getStealingPolicy()));
+    xmlAudioEngine->setAttribute("numRenderThreads", getNumRenderThreads());
 
     for (int id = 0; serialisationSuccessful && id <= regionIdCounter; ++id)
     {
@@ -186,8 +196,11 @@ bool AudioEngine::deserialise(juce::XmlElement* xml, juce::Array<juce::MemoryBlo
 }
 bool AudioEngine::deserialiseImage(juce::XmlElement* xmlAudioEngine, juce::Array<juce::MemoryBlock>* attachedData)
 {
-    //return associatedImage.get()->deserialise(xmlAudioEngine, attachedData); //restores image and all its regions;
-    return associatedImage->deserialise(xmlAudioEngine, attachedData); //restores image and all its regions;
+    sampleStore.beginDeserialisation(); //samples that are used by several regions are only restored once
+    //bool deserialisationSuccessful = associatedImage.get()->deserialise(xmlAudioEngine, attachedData); //restores image and all its regions;
+    bool deserialisationSuccessful = associatedImage->deserialise(xmlAudioEngine, attachedData); //restores image and all its regions;
+    sampleStore.endDeserialisation();
+    return deserialisationSuccessful;
 }
 bool AudioEngine::deserialiseRegionColours(juce::XmlElement* xmlAudioEngine)
 {
@@ -324,6 +337,16 @@ bool AudioEngine::deserialiseVoices(juce::XmlElement* xmlAudioEngine)
     //-> pass the same XmlElement to all [number of voices] Voice members to initialise them all with the same values
     bool deserialisationSuccessful = true;
 
+    voicePool.setMaxActiveVoices(xmlAudioEngine->getIntAttribute("maxActiveVoices", VoicePool::unlimitedVoices));
+    int stealingPolicy = xmlAudioEngine->getIntAttribute("voiceStealingPolicy", static_cast<int>(VoiceStealingPolicy::oldest));
+    if (stealingPolicy < static_cast<int>(VoiceStealingPolicy::oldest) || stealingPolicy > static_cast<int>(VoiceStealingPolicy::releasingFirst))
+    {
+        DBG("unknown voice stealing policy " + juce::String(stealingPolicy) + ". using the default policy instead.");
+        stealingPolicy = static_cast<int>(VoiceStealingPolicy::oldest); //e.g. saved by a newer version or corrupted
+    }
+    voicePool.setStealingPolicy(static_cast<VoiceStealingPolicy>(stealingPolicy));
+    setNumRenderThreads(xmlAudioEngine->getIntAttribute("numRenderThreads", getDefaultNumRenderThreads()));
+
     for (int id = 0; deserialisationSuccessful && id <= regionIdCounter; ++id)
     {
         juce::XmlElement* xmlVoices = xmlAudioEngine->getChildByName("Voices_" + juce::String(id));
@@ -363,7 +386,7 @@ SegmentableImage* AudioEngine::getImage()
 
 int AudioEngine::getNextRegionID()
 {
-    while (takenRegionIDs.contains(++regionIdCounter))
+    while (isRegionIDTaken(++regionIdCounter))
     {
         //ID already taken (this might be due to deserialisation because there, regions may change their IDs. that's because users may have previously deleted a region)
         //-> just keep incrementing until a valid ID is hit. this shouldn't take long.
@@ -417,38 +440,31 @@ bool AudioEngine::tryChangeRegionID(int regionID, int newRegionID)
         //already done
         return true;
     }
-    else if (newRegionID < 0 || takenRegionIDs.contains(newRegionID))
+    else if (newRegionID < 0 || isRegionIDTaken(newRegionID))
     {
+        //found a region with the new ID -> new ID already exists -> abort
         return false;
     }
-
-    //check whether the new ID isn't already taken by another region
-    for (auto itLfo = lfos.begin(); itLfo != lfos.end(); ++itLfo)
-    {
-        //every existing region has an LFO, so if there is an LFO belonging to a region with the new ID, a region with that ID exists
-        if ((*itLfo)->getRegionID() == newRegionID)
-        {
-            //found a region with the new ID -> new ID already exists -> abort
-            return false;
-        }
-    }
     //new ID isn't already taken
 
     DBG("changing region " + juce::String(regionID) + "'s ID to " + juce::String(newRegionID) + "...");
 
+    invalidateModulationGraph(); //the groups and the modulation matrix are based on region IDs
+
+    //move the region's entry to the new ID
+    getOrCreateRegionEntry(juce::jmax(regionID, newRegionID)); //makes sure that both indices exist
+    regionTable.swap(regionID, newRegionID); //the new ID's entry is empty
+    auto* entry = regionTable[newRegionID];
+
     //adjust the ID of the LFO of the affected region
-    int changes = 0;
-    for (auto itLfo = lfos.begin(); itLfo != lfos.end(); ++itLfo)
+    if (entry->lfo != nullptr)
     {
-        if ((*itLfo)->getRegionID() == regionID)
-        {
-            //found the LFO of the affected region
-            (*itLfo)->setRegionID(newRegionID);
-            changes++;
-            break; //only one LFO per region
-        }
+        entry->lfo->setRegionID(newRegionID);
+    }
+    else
+    {
+        DBG("region " + juce::String(regionID) + " doesn't have an LFO.");
     }
-    DBG(juce::String(changes) + " LFOs have been changed (should be 1).");
 
     //signal to all other LFOs that this LFO's ID has changed
     for (auto itOtherLfo = lfos.begin(); itOtherLfo != lfos.end(); ++itOtherLfo)
@@ -460,18 +476,8 @@ bool AudioEngine::tryChangeRegionID(int regionID, int newRegionID)
     }
 
     //adjust the ID of all voices of the affected region
-    changes = 0;
-    for (int i = 0; i < synth.getNumVoices(); ++i)
-    {
-        Voice* v = static_cast<Voice*>(synth.getVoice(i));
-
-        if (v->getID() == regionID)
-        {
-            v->setID(newRegionID);
-            changes++;
-        }
-    }
-    DBG(juce::String(changes) + " voices have been changed (should be " + juce::String(defaultPolyphony) + ").");
+    voicePool.changeRegionID(regionID, newRegionID); //also sets the voices' IDs, so that voices which stop meanwhile are handed back to the right region
+    DBG(juce::String(entry->voices.size()) + " voices have been changed.");
 
     //adjust the list of taken region IDs
     takenRegionIDs.removeAllInstancesOf(regionID);
@@ -491,6 +497,17 @@ void AudioEngine::removeMidiListener(juce::MidiKeyboardState::Listener* midiList
     keyboardState.removeListener(midiListener);
 }
 
+void AudioEngine::addPlayPath(PlayPath* newPlayPath)
+{
+    const juce::SpinLock::ScopedLockType sl(playPathLock);
+    playPaths.addIfNotAlreadyThere(newPlayPath);
+}
+void AudioEngine::removePlayPath(PlayPath* playPath)
+{
+    const juce::SpinLock::ScopedLockType sl(playPathLock); //waits until the audio thread has stopped moving the path's couriers
+    playPaths.removeFirstMatchingValue(playPath);
+}
+
 juce::Colour AudioEngine::getRegionColour(int regionID)
 {
     if (regionID >= 0 && regionID <= regionColours.size())
@@ -516,14 +533,18 @@ void AudioEngine::initialiseVoicesForRegion(int regionID, int voiceCount)
 int AudioEngine::addVoice(Voice* newVoice)
 {
     newVoice->prepare(specs);
+    invalidateModulationGraph();
 
-    auto* associatedLfo = getLfo(newVoice->getID());
-    if (associatedLfo != nullptr)
+    auto* entry = getOrCreateRegionEntry(newVoice->getID());
+    if (entry->lfo != nullptr)
     {
-        newVoice->setLfo(associatedLfo); //make the new voice advance the LFO associated with the same region
+        newVoice->setLfo(entry->lfo); //make the new voice read the LFO associated with the same region
     }
 
+    voicePool.addVoice(newVoice);
     synth.addVoice(newVoice);
+    entry->voices.add(newVoice);
+    updateParameterHandles(entry);
 
     DBG("successfully added voice #" + juce::String(synth.getNumVoices() - 1) + ". associated region: " + juce::String(newVoice->getID()));
 
@@ -531,111 +552,152 @@ int AudioEngine::addVoice(Voice* newVoice)
 }
 juce::Array<Voice*> AudioEngine::getVoicesWithID(int regionID)
 {
-    juce::Array<Voice*> voiceList;
-
-    for (int i = 0; i < synth.getNumVoices(); ++i)
-    {
-        auto curVoice = static_cast<Voice*>(synth.getVoice(i));
-
-        if (curVoice->getID() == regionID)
-        {
-            voiceList.add(curVoice);
-        }
-    }
-
-    return voiceList;
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->voices : juce::Array<Voice*>();
 }
 bool AudioEngine::checkRegionHasVoice(int regionID)
 {
-    if (getVoicesWithID(regionID).size() > 0)
-        return true;
-    else
-        return false;
+    auto* entry = getRegionEntry(regionID);
+    return entry != nullptr && entry->voices.size() > 0;
 }
 void AudioEngine::removeVoicesWithID(int regionID)
 {
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    invalidateModulationGraph(); //before removing anything, so that the removed voices cannot be rendered in parallel or modulated by the matrix anymore
+
+    auto* entry = getRegionEntry(regionID);
+    if (entry == nullptr || entry->voices.size() == 0)
+    {
+        return;
+    }
+
+    for (auto itVoice = entry->voices.begin(); itVoice != entry->voices.end(); ++itVoice)
+    {
+        voicePool.removeVoice(*itVoice); //before the voice is deleted, so that it cannot be started anymore
+    }
+    for (int i = synth.getNumVoices() - 1; i >= 0; --i) //the synth can only remove voices by index
     {
-        auto* curVoice = static_cast<Voice*>(synth.getVoice(i));
-        if (curVoice->getID() == regionID)
+        if (static_cast<Voice*>(synth.getVoice(i))->getID() == regionID)
         {
             synth.removeVoice(i);
-            --i;
         }
     }
-}
 
-juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_Volume(int regionID)
+    entry->voices.clear();
+    updateParameterHandles(entry);
+}
+void AudioEngine::setRegionPolyphony(int regionID, int polyphony)
 {
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
-
-    for (auto* it = voices.begin(); it != voices.end(); it++)
+    polyphony = juce::jlimit(1, maxPolyphony, polyphony);
+    auto* entry = getRegionEntry(regionID);
+    if (entry == nullptr || entry->voices.size() == polyphony)
     {
-        parameters.add((*it)->getLevelParameter());
+        return;
     }
 
-    return parameters;
-}
-juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_Pitch(int regionID)
-{
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
+    DBG("changing the polyphony of region " + juce::String(regionID) + " from " + juce::String(entry->voices.size()) + " to " + juce::String(polyphony) + "...");
 
-    for (auto* it = voices.begin(); it != voices.end(); it++)
+    //build the new voices on this thread. the synth doesn't know them yet, so they can be set up without suspending the audio engine.
+    //all voices of a region have the same parameters -> copy them from the current voices
+    juce::XmlElement xmlVoiceParameters("Voices");
+    bool hasParameters = entry->voices.size() > 0 && entry->voices[0]->serialise(&xmlVoiceParameters);
+
+    juce::Array<Voice*> newVoices;
+    for (int i = 0; i < polyphony; ++i)
     {
-        parameters.add((*it)->getPitchShiftParameter());
+        auto* newVoice = new Voice(regionID);
+        newVoice->prepare(specs);
+        if (entry->lfo != nullptr)
+        {
+            newVoice->setLfo(entry->lfo);
+        }
+        if (hasParameters)
+        {
+            newVoice->deserialise(&xmlVoiceParameters);
+        }
+        newVoices.add(newVoice);
     }
 
-    return parameters;
-}
-juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_PlaybackPositionStart(int regionID)
-{
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
+    invalidateModulationGraph(); //the groups and the modulation matrix refer to the old voices
 
-    for (auto* it = voices.begin(); it != voices.end(); it++)
+    //swap the voices. only pointers change while the audio thread is locked out; the old voices are deleted afterwards
+    juce::OwnedArray<Voice> oldVoices;
     {
-        parameters.add((*it)->getPlaybackPositionStartParameter());
+        const juce::ScopedLock sl(synth.getLock());
+
+        for (auto itVoice = entry->voices.begin(); itVoice != entry->voices.end(); ++itVoice)
+        {
+            voicePool.removeVoice(*itVoice);
+        }
+        for (int i = synth.getNumVoices() - 1; i >= 0; --i) //the synth can only remove voices by index
+        {
+            if (static_cast<Voice*>(synth.getVoice(i))->getID() == regionID)
+            {
+                oldVoices.add(static_cast<Voice*>(synth.releaseVoice(i)));
+            }
+        }
+
+        for (auto itVoice = newVoices.begin(); itVoice != newVoices.end(); ++itVoice)
+        {
+            voicePool.addVoice(*itVoice);
+            synth.addVoice(*itVoice);
+        }
+        entry->voices = newVoices;
+        updateParameterHandles(entry);
+
+        //modulations of the region's parameters still refer to the old voices -> reconnect them to the new ones
+        //(the parameters' modulator lists are read while rendering, so this happens while the audio thread is still locked out)
+        for (auto itLfo = lfos.begin(); itLfo != lfos.end(); ++itLfo)
+        {
+            auto affectedRegionIDs = (*itLfo)->getAffectedRegionIDs();
+            auto modulatedParameterIDs = (*itLfo)->getModulatedParameterIDs();
+
+            for (int i = 0; i < affectedRegionIDs.size(); ++i)
+            {
+                juce::Array<ModulatableParameter<double>*> parameters;
+                if (affectedRegionIDs[i] == regionID && getModulatableParametersOfRegion(regionID, modulatedParameterIDs[i], parameters))
+                {
+                    (*itLfo)->addRegionModulation(modulatedParameterIDs[i], regionID, parameters); //replaces the modulation of the old voices
+                }
+            }
+        }
     }
 
-    return parameters;
+    //oldVoices is deleted here (outside of the lock)
 }
-juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_PlaybackPositionInterval(int regionID)
+VoicePool* AudioEngine::getVoicePool()
 {
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
-
-    for (auto* it = voices.begin(); it != voices.end(); it++)
-    {
-        parameters.add((*it)->getPlaybackPositionIntervalParameter());
-    }
+    return &voicePool;
+}
 
-    return parameters;
+juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_Volume(int regionID)
+{
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->volumeParameters : juce::Array<ModulatableParameter<double>*>();
+}
+juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_Pitch(int regionID)
+{
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->pitchParameters : juce::Array<ModulatableParameter<double>*>();
+}
+juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_PlaybackPositionStart(int regionID)
+{
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->playbackPositionStartParameters : juce::Array<ModulatableParameter<double>*>();
+}
+juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_PlaybackPositionInterval(int regionID)
+{
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->playbackPositionIntervalParameters : juce::Array<ModulatableParameter<double>*>();
 }
 juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_PlaybackPositionCurrent(int regionID)
 {
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
-
-    for (auto* it = voices.begin(); it != voices.end(); it++)
-    {
-        parameters.add((*it)->getPlaybackPositionCurrentParameter());
-    }
-
-    return parameters;
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->playbackPositionCurrentParameters : juce::Array<ModulatableParameter<double>*>();
 }
 juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_FilterPosition(int regionID)
 {
-    juce::Array<Voice*> voices = getVoicesWithID(regionID);
-    juce::Array<ModulatableParameter<double>*> parameters;
-
-    for (auto* it = voices.begin(); it != voices.end(); it++)
-    {
-        parameters.add((*it)->getFilterPositionParameter());
-    }
-
-    return parameters;
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->filterPositionParameters : juce::Array<ModulatableParameter<double>*>();
 }
 juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_LfoRate(int regionID)
 {
@@ -700,7 +762,6 @@ juce::Array<ModulatableParameter<double>*> AudioEngine::getParameterOfRegion_Lfo
 
 bool AudioEngine::updateLfoParameter(int lfoID, int targetRegionID, bool shouldBeModulated, LfoModulatableParameter modulatedParameter)
 {
-    bool wasSuspended = isSuspended();
     RegionLfo* lfo = getLfo(lfoID);
 
     if (lfo == nullptr)
@@ -709,92 +770,103 @@ bool AudioEngine::updateLfoParameter(int lfoID, int targetRegionID, bool shouldB
         return false;
     }
 
+    invalidateModulationGraph(); //the matrix needs to be recompiled
+
     if (!shouldBeModulated || static_cast<int>(modulatedParameter) <= 0)
     {
-        suspendProcessing(true);
+        const juce::ScopedLock sl(synth.getLock()); //the audio thread evaluates the LFO's modulations while holding this lock
         lfo->removeRegionModulation(targetRegionID); //removing modulation is the same for every region
-        suspendProcessing(wasSuspended);
         return true;
     }
 
     //there are different overloads for RegionLfo::addRegionModulation depending on whether a voice is modulated or an LFO
-    suspendProcessing(true);
+    juce::Array<ModulatableParameter<double>*> parameters;
+    if (!getModulatableParametersOfRegion(targetRegionID, modulatedParameter, parameters))
+    {
+        DBG("Unknown or unimplemented region modulation");
+        return false;
+    }
+
+    //the parameters have been gathered above, so the lock is only held while the modulation is registered
+    const juce::ScopedLock sl(synth.getLock());
+    lfo->addRegionModulation(modulatedParameter, targetRegionID, parameters);
+    return true;
+}
+bool AudioEngine::getModulatableParametersOfRegion(int regionID, LfoModulatableParameter modulatedParameter, juce::Array<ModulatableParameter<double>*>& parameters)
+{
     switch (modulatedParameter)
     {
     case LfoModulatableParameter::volume:
     case LfoModulatableParameter::volume_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_Volume(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_Volume(regionID);
+        return true;
 
     case LfoModulatableParameter::pitch:
     case LfoModulatableParameter::pitch_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_Pitch(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_Pitch(regionID);
+        return true;
 
     case LfoModulatableParameter::playbackPositionStart:
     case LfoModulatableParameter::playbackPositionStart_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_PlaybackPositionStart(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_PlaybackPositionStart(regionID);
+        return true;
 
     case LfoModulatableParameter::playbackPositionInterval:
     case LfoModulatableParameter::playbackPositionInterval_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_PlaybackPositionInterval(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_PlaybackPositionInterval(regionID);
+        return true;
 
     case LfoModulatableParameter::playbackPositionCurrent:
     case LfoModulatableParameter::playbackPositionCurrent_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_PlaybackPositionCurrent(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_PlaybackPositionCurrent(regionID);
+        return true;
 
     case LfoModulatableParameter::filterPosition:
     case LfoModulatableParameter::filterPosition_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_FilterPosition(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_FilterPosition(regionID);
+        return true;
 
 
 
 
     case LfoModulatableParameter::lfoRate:
     case LfoModulatableParameter::lfoRate_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_LfoRate(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_LfoRate(regionID);
+        return true;
 
     case LfoModulatableParameter::lfoStartingPhase:
     case LfoModulatableParameter::lfoStartingPhase_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_LfoStartingPhase(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_LfoStartingPhase(regionID);
+        return true;
 
     case LfoModulatableParameter::lfoPhaseInterval:
     case LfoModulatableParameter::lfoPhaseInterval_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_LfoPhaseInterval(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_LfoPhaseInterval(regionID);
+        return true;
 
     case LfoModulatableParameter::lfoCurrentPhase:
     case LfoModulatableParameter::lfoCurrentPhase_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_LfoCurrentPhase(targetRegionID));
-        break;
+        parameters = getParameterOfRegion_LfoCurrentPhase(regionID);
+        return true;
 
     case LfoModulatableParameter::lfoUpdateInterval:
     case LfoModulatableParameter::lfoUpdateInterval_inverted:
-        lfo->addRegionModulation(modulatedParameter, targetRegionID, getParameterOfRegion_LfoUpdateInterval(targetRegionID));
-        break;
-
-
-
+        parameters = getParameterOfRegion_LfoUpdateInterval(regionID);
+        return true;
 
     default:
-        DBG("Unknown or unimplemented region modulation");
-        suspendProcessing(wasSuspended);
-        return false;
+        return false; //unknown or unimplemented region modulation
     }
-
-    suspendProcessing(wasSuspended);
-    return true;
 }
 
-void AudioEngine::prepareToPlay(int /*samplesPerBlockExpected*/, double sampleRate)
+void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
     specs.sampleRate = sampleRate;
+    specs.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlockExpected);
+
+    incomingMidi.ensureSize(2048); //avoids allocations on the audio thread
+    injectedMidi.ensureSize(2048);
+    synth.prepareRenderBuffers(juce::jmax(2, associatedProcessor.getTotalNumOutputChannels()), samplesPerBlockExpected);
 
     synth.setCurrentPlaybackSampleRate(sampleRate); // [3]
     for (int i = 0; i < synth.getNumVoices(); ++i)
@@ -807,6 +879,9 @@ void AudioEngine::prepareToPlay(int /*samplesPerBlockExpected*/, double sampleRa
         (*it)->prepare(specs);
     }
 
+    preparedSampleRate.store(sampleRate);
+    triggerAsyncUpdate(); //samples at other rates are resampled to the new rate on the message thread (see handleAsyncUpdate)
+
     DBG("AudioEngine prepared to play. sample rate: " + juce::String(sampleRate));
 }
 void AudioEngine::suspendProcessing(bool shouldBeSuspended)
@@ -827,7 +902,20 @@ void AudioEngine::panic()
 void AudioEngine::releaseResources()
 {
     DBG("AudioEngine: releasing resources...");
-    lfos.clear(true);
+    invalidateModulationGraph();
+    {
+        const juce::ScopedLock sl(synth.getLock()); //the modulation matrix mustn't access the LFOs while they are being deleted
+        for (auto itEntry = regionTable.begin(); itEntry != regionTable.end(); ++itEntry)
+        {
+            //no dangling pointers to the deleted LFOs (see removeLfo)
+            for (auto itVoice = (*itEntry)->voices.begin(); itVoice != (*itEntry)->voices.end(); ++itVoice)
+            {
+                (*itVoice)->setLfo(nullptr);
+            }
+            (*itEntry)->lfo = nullptr;
+        }
+        lfos.clear(true);
+    }
     DBG("AudioEngine: resources have been released.");
 }
 
@@ -835,25 +923,183 @@ void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferTo
 {
     bufferToFill.clearActiveBufferRegion();
 
-    juce::MidiBuffer incomingMidi;
+    incomingMidi.clear();
     midiCollector.removeNextBlockOfMessages(incomingMidi, bufferToFill.numSamples);
-    keyboardState.processNextMidiBuffer(incomingMidi, bufferToFill.startSample, bufferToFill.numSamples, true);       // [4]
 
-    //evaluate all voices sample by sample! this is crucial since every voice *must* be rendered in sync with its LFO.
-    //but since different voices' LFOs can influence one another, all voices must be rendered perfectly in sync as well!
-    //the main disadvantage of this is that some processing (e.g. many types of filters, EQs or convolution-based effects)
-    //might not be simple to implement (or even possible) anymore like this since they need to be rendered in block (since they require an FFT).
-    //there may be workarounds for this, though.
-    for (int i = bufferToFill.startSample; i < bufferToFill.startSample + bufferToFill.numSamples; ++i)
+    //events from the on-screen keyboard have already been handled by the keyboard state when they were entered. this call only empties its queue of those events.
+    injectedMidi.clear();
+    keyboardState.processNextMidiBuffer(injectedMidi, bufferToFill.startSample, bufferToFill.numSamples, true);
+
+    //every voice *must* be rendered in sync with its LFO. but since different voices' LFOs can influence one another, all voices must be rendered in sync as well!
+    //previously, this was achieved by rendering the synth sample by sample, which made every sample pay for the synth's MIDI handling and voice iteration.
+    //instead, the block is now split into sub-blocks that end at every MIDI event and after at most controlRateChunkSize samples.
+    //all voices (and thereby all LFOs and their modulated parameters) advance in lockstep from one sub-block to the next,
+    //so modulations between different regions are delayed by less than one chunk. a chunk size of 1 reproduces the sample-by-sample behaviour exactly.
+    const int endSample = bufferToFill.startSample + bufferToFill.numSamples;
+    auto itEvent = incomingMidi.cbegin();
+
+    //block boundary -> pick up new wavetables that have been built by the message thread in the meantime (the voices pick up their new files themselves)
+    {
+        const juce::ScopedLock sl(synth.getLock());
+        for (auto* lfo : lfos)
+        {
+            lfo->applyPendingWaveTable();
+        }
+    }
+
+    for (int subBlockStart = bufferToFill.startSample; subBlockStart < endSample; )
+    {
+        //handle all MIDI events that are due (sample-accurately, since they may start regions or play paths)
+        for (; itEvent != incomingMidi.cend() && (*itEvent).samplePosition <= subBlockStart; ++itEvent)
+        {
+            keyboardState.processNextMidiEvent((*itEvent).getMessage());
+        }
+
+        //the sub-block ends at the next control-rate chunk boundary, at the next MIDI event or where the next courier enters or exits a region, whichever comes first
+        int subBlockEnd = juce::jmin(endSample, subBlockStart + controlRateChunkSize);
+        if (itEvent != incomingMidi.cend())
+        {
+            subBlockEnd = juce::jmin(subBlockEnd, (*itEvent).samplePosition);
+        }
+        subBlockEnd = subBlockStart + getSamplesUntilNextCourierEvent(subBlockEnd - subBlockStart);
+
+        //apply all modulations of the voices that have been updated during the previous sub-block in one pass (the LFOs are modulated in advanceLfos)
+        {
+            const juce::ScopedLock sl(synth.getLock()); //not held while handling MIDI, since that may call functions on the message thread
+            if (modulationMatrix != nullptr && modulationMatrix->getVersion() == modulationMatrixVersion.load())
+            {
+                modulationMatrix->process();
+            }
+        }
+
+        synth.renderNextBlock(*bufferToFill.buffer, incomingMidi, subBlockStart, subBlockEnd - subBlockStart);
+
+        //modulations are evaluated at control rate, so the LFOs can be advanced after the voices have rendered their samples
+        advanceLfos(subBlockEnd - subBlockStart);
+
+        //move the couriers to the end of the sub-block. regions that they enter or exit there are started or stopped before the next sub-block is rendered (sample-accurately)
+        advanceCouriers(subBlockEnd - subBlockStart);
+        subBlockStart = subBlockEnd;
+    }
+}
+
+void AudioEngine::advanceLfos(int numSamples)
+{
+    //every LFO whose region is playing advances exactly once per sub-block, no matter how many of the region's voices are playing. the voices only read the LFOs' outputs
+    const juce::ScopedLock sl(synth.getLock());
+    ++lfoControlStep;
+
+    bool useMatrix = modulationMatrix != nullptr && modulationMatrix->getVersion() == modulationMatrixVersion.load();
+
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        auto* voice = static_cast<Voice*>(synth.getVoice(i));
+        RegionLfo* lfo = voice->getLfo();
+
+        if (lfo != nullptr && voice->isPlaying() && lfo->claimControlStep(lfoControlStep) && !useMatrix)
+        {
+            lfo->advanceBlock(numSamples);
+            lfoBatch.add(lfo); //only added if it has updated
+        }
+    }
+
+    if (!useMatrix)
+    {
+        lfoBatch.evaluate();
+        return;
+    }
+
+    //advance level by level, so that LFOs modulated by other LFOs see the values that those have reached during this step (feedback links: the previous step)
+    for (int level = 0; level < modulationMatrix->getNumLevels(); ++level)
+    {
+        modulationMatrix->processLfoLevel(level);
+
+        for (int s = modulationMatrix->getLevelStart(level); s < modulationMatrix->getLevelStart(level + 1); ++s)
+        {
+            RegionLfo* lfo = modulationMatrix->getSource(s);
+            if (lfo->hasClaimedControlStep(lfoControlStep))
+            {
+                lfo->advanceBlock(numSamples);
+                lfoBatch.add(lfo); //only added if it has updated
+            }
+        }
+
+        lfoBatch.evaluate(); //before the next level reads the LFOs' values
+    }
+}
+int AudioEngine::getSamplesUntilNextCourierEvent(int maxSamples)
+{
+    if (specs.sampleRate <= 0.0)
+    {
+        return maxSamples; //not prepared yet
+    }
+
+    const juce::SpinLock::ScopedLockType sl(playPathLock);
+    int samplesUntilNextEvent = maxSamples;
+    for (auto itPath = playPaths.begin(); itPath != playPaths.end(); ++itPath)
+    {
+        samplesUntilNextEvent = (*itPath)->getSamplesUntilNextCourierEvent(samplesUntilNextEvent, specs.sampleRate);
+    }
+    return samplesUntilNextEvent;
+}
+void AudioEngine::advanceCouriers(int numSamples)
+{
+    if (specs.sampleRate <= 0.0)
+    {
+        return; //not prepared yet
+    }
+
+    const juce::SpinLock::ScopedLockType sl(playPathLock);
+    for (auto itPath = playPaths.begin(); itPath != playPaths.end(); ++itPath)
+    {
+        (*itPath)->advanceCouriers(numSamples, specs.sampleRate);
+    }
+}
+
+double AudioEngine::getSampleRate()
+{
+    return preparedSampleRate.load();
+}
+
+int AudioEngine::getControlRateChunkSize()
+{
+    return controlRateChunkSize;
+}
+void AudioEngine::setControlRateChunkSize(int newControlRateChunkSize)
+{
+    controlRateChunkSize = juce::jmax(1, newControlRateChunkSize);
+}
+
+int AudioEngine::getNumRenderThreads()
+{
+    return synth.getNumWorkers();
+}
+void AudioEngine::setNumRenderThreads(int newNumRenderThreads)
+{
+    newNumRenderThreads = juce::jlimit(0, getDefaultNumRenderThreads(), newNumRenderThreads);
+
+    if (newNumRenderThreads != synth.getNumWorkers()) //restarting the workers isn't free, so presets with the same setting leave them running
     {
-        synth.renderNextBlock(*bufferToFill.buffer, incomingMidi, i, 1); //sample by sample
+        synth.setNumWorkers(newNumRenderThreads);
     }
 }
+int AudioEngine::getDefaultNumRenderThreads()
+{
+    return juce::jmax(0, juce::SystemStats::getNumCpus() - 1);
+}
 
 juce::Synthesiser* AudioEngine::getSynth()
 {
     return &synth;
 }
+SampleStore* AudioEngine::getSampleStore()
+{
+    return &sampleStore;
+}
+AudioFileLoader* AudioEngine::getFileLoader()
+{
+    return &fileLoader;
+}
 
 void AudioEngine::addLfo(RegionLfo* newLfo)
 {
@@ -861,16 +1107,21 @@ void AudioEngine::addLfo(RegionLfo* newLfo)
     //int newLfoIndex = lfos.size();
     newLfo->prepare(specs);
     newLfo->setBaseFrequency(0.2f);
-    lfos.add(newLfo);
+    invalidateModulationGraph();
+
+    auto* entry = getOrCreateRegionEntry(regionID);
 
-    for (int i = 0; i < synth.getNumVoices(); ++i)
     {
-        auto* curVoice = static_cast<Voice*>(synth.getVoice(i));
-        if (curVoice->getID() == regionID)
+        const juce::ScopedLock sl(synth.getLock()); //only held for a few pointer changes, so the audio thread doesn't need to be suspended
+        lfos.add(newLfo);
+        lfoBatch.reserve(lfos.size());
+        entry->lfo = newLfo;
+
+        for (auto itVoice = entry->voices.begin(); itVoice != entry->voices.end(); ++itVoice)
         {
-            //all voices belonging to the same region as the LFO will now advance this LFO
-            //(as long as they aren't tailing off, i.e. it's only 1 voice advancing it, but it could be any of these voices)
-            curVoice->setLfo(newLfo);
+            //all voices belonging to the same region as the LFO will now read this LFO
+            //(it's advanced by advanceLfos while any of these voices is playing)
+            (*itVoice)->setLfo(newLfo);
         }
     }
 
@@ -878,45 +1129,69 @@ void AudioEngine::addLfo(RegionLfo* newLfo)
 }
 RegionLfo* AudioEngine::getLfo(int regionID)
 {
-    for (auto it = lfos.begin(); it != lfos.end(); ++it)
-    {
-        if ((*it)->getRegionID() == regionID)
-        {
-            return (*it);
-        }
-    }
-    return nullptr; //no LFO associated with this region ID found
+    auto* entry = getRegionEntry(regionID);
+    return (entry != nullptr) ? entry->lfo : nullptr; //nullptr if no LFO is associated with this region ID
 }
 void AudioEngine::removeLfo(int regionID) //removes the LFO of the region with the given ID
 {
-    int lfoIndex = -1;
-
-    for (auto it = lfos.begin(); it != lfos.end(); ++it)
+    auto* entry = getRegionEntry(regionID);
+    if (entry == nullptr || entry->lfo == nullptr)
     {
-        if ((*it)->getRegionID() == regionID)
-        {
-            //LFO found -> remove
-            lfoIndex = lfos.indexOf((*it));
-            break;
-        }
+        //no LFO with this ID found
+        return;
     }
 
-    if (lfoIndex < 0)
+    invalidateModulationGraph();
+
+    for (auto itVoice = entry->voices.begin(); itVoice != entry->voices.end(); ++itVoice)
     {
-        //no LFO with this ID found
-        return;
+        (*itVoice)->setLfo(nullptr); //clear associated LFO
     }
 
-    for (int i = 0; i < synth.getNumVoices(); ++i)
     {
-        auto* curVoice = static_cast<Voice*>(synth.getVoice(i));
-        if (curVoice->getID() == regionID)
-        {
-            curVoice->setLfo(nullptr); //clear associated LFO
-        }
+        const juce::ScopedLock sl(synth.getLock()); //the modulation matrix mustn't access the LFO while it is being deleted
+        lfos.removeObject(entry->lfo, true);
+        entry->lfo = nullptr;
     }
+}
 
-    lfos.remove(lfoIndex, true);
+AudioEngine::RegionEntry* AudioEngine::getRegionEntry(int regionID)
+{
+    return regionTable[regionID]; //nullptr if out of range
+}
+AudioEngine::RegionEntry* AudioEngine::getOrCreateRegionEntry(int regionID)
+{
+    jassert(regionID >= 0);
+
+    while (regionTable.size() <= regionID)
+    {
+        regionTable.add(new RegionEntry());
+    }
+    return regionTable[regionID];
+}
+bool AudioEngine::isRegionIDTaken(int regionID)
+{
+    auto* entry = getRegionEntry(regionID);
+    return entry != nullptr && (entry->lfo != nullptr || entry->voices.size() > 0);
+}
+void AudioEngine::updateParameterHandles(RegionEntry* entry)
+{
+    entry->volumeParameters.clearQuick();
+    entry->pitchParameters.clearQuick();
+    entry->playbackPositionStartParameters.clearQuick();
+    entry->playbackPositionIntervalParameters.clearQuick();
+    entry->playbackPositionCurrentParameters.clearQuick();
+    entry->filterPositionParameters.clearQuick();
+
+    for (auto itVoice = entry->voices.begin(); itVoice != entry->voices.end(); ++itVoice)
+    {
+        entry->volumeParameters.add((*itVoice)->getLevelParameter());
+        entry->pitchParameters.add((*itVoice)->getPitchShiftParameter());
+        entry->playbackPositionStartParameters.add((*itVoice)->getPlaybackPositionStartParameter());
+        entry->playbackPositionIntervalParameters.add((*itVoice)->getPlaybackPositionIntervalParameter());
+        entry->playbackPositionCurrentParameters.add((*itVoice)->getPlaybackPositionCurrentParameter());
+        entry->filterPositionParameters.add((*itVoice)->getFilterPositionParameter());
+    }
 }
 
 
@@ -927,8 +1202,66 @@ void AudioEngine::resetAll()
     DBG("resetting AudioEngine...");
     associatedImage->transitionToState(SegmentableImageStateIndex::empty);
     regionColours.clear();
+    invalidateModulationGraph();
+    voicePool.clear();
     synth.clearVoices();
-    lfos.clear(true);
+    {
+        const juce::ScopedLock sl(synth.getLock()); //the modulation matrix mustn't access the LFOs while they are being deleted
+        lfos.clear(true);
+    }
+    regionTable.clear(true);
     regionIdCounter = -1;
     DBG("AudioEngine has been reset.");
-}
\ No newline at end of file
+}
+
+void AudioEngine::invalidateModulationGraph()
+{
+    synth.invalidateVoiceGroups(); //voices will be rendered serially until the groups have been rebuilt (voices may have been added or removed)
+    modulationMatrixVersion.fetch_add(1); //the matrix won't be processed until it has been recompiled
+    triggerAsyncUpdate(); //several changes in a row (e.g. during deserialisation) only cause one rebuild
+}
+void AudioEngine::handleAsyncUpdate()
+{
+    rebuildVoiceGroups();
+    rebuildModulationMatrix();
+    sampleStore.setTargetSampleRate(preparedSampleRate.load()); //does nothing if the rate hasn't changed
+}
+void AudioEngine::rebuildVoiceGroups()
+{
+    //voices can be rendered in parallel as long as they don't write to anything that other voices read. LFOs are advanced by advanceLfos on the audio thread
+    //after the voices of a sub-block have been rendered (never during rendering), so while rendering, the voices only read the LFOs' outputs, no matter how the regions modulate one another.
+    //-> every region is its own group. (the voices of one region are kept together, since they share their sample data and thus the cache)
+    int version = synth.getVoiceGroupsVersion();
+
+    juce::Array<int> groupIndexOfRegion;
+    groupIndexOfRegion.insertMultiple(0, -1, regionTable.size()); //every voice has an entry
+    juce::Array<juce::Array<int>> voiceGroups;
+
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        int regionID = static_cast<Voice*>(synth.getVoice(i))->getID();
+        if (groupIndexOfRegion[regionID] < 0)
+        {
+            groupIndexOfRegion.set(regionID, voiceGroups.size());
+            voiceGroups.add(juce::Array<int>());
+        }
+        voiceGroups.getReference(groupIndexOfRegion[regionID]).add(i);
+    }
+
+    synth.setVoiceGroups(voiceGroups, version);
+    DBG("voice groups rebuilt: " + juce::String(voiceGroups.size()) + " independent groups");
+}
+void AudioEngine::rebuildModulationMatrix()
+{
+    //compiling the matrix requires the LFOs and parameters to stay the same, which is ensured by only ever changing them on the message thread
+    int version = modulationMatrixVersion.load();
+    auto newMatrix = std::make_unique<ModulationMatrix>(lfos, version);
+
+    {
+        const juce::ScopedLock sl(synth.getLock()); //the matrix is only ever processed while holding this lock
+        std::swap(modulationMatrix, newMatrix);
+    }
+    //newMatrix now contains the old matrix, which is deleted here (outside of the lock)
+
+    DBG("modulation matrix rebuilt: " + juce::String(modulationMatrix->getNumLinks()) + " links, " + juce::String(modulationMatrix->getNumFeedbackLinks()) + " of which are feedback links");
+}
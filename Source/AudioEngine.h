@@ -15,8 +15,15 @@
 #include "ModulatableParameter.h"
 #include "Voice.h"
 #include "RegionLfo.h"
+#include "RegionLfoBatch.h"
+#include "MultiCoreSynthesiser.h"
+#include "ModulationMatrix.h"
+#include "AudioFileLoader.h"
+#include "SampleStore.h"
+#include "VoicePool.h"
 
 class SegmentableImage; //don't include the header here yet (crossreferences), it'll be in the cpp
+class PlayPath;
 
 struct TempSound : public juce::SynthesiserSound
 {
@@ -27,7 +34,7 @@ struct TempSound : public juce::SynthesiserSound
 };
 
 //==============================================================================
-class AudioEngine  : public juce::AudioSource
+class AudioEngine  : public juce::AudioSource, private juce::AsyncUpdater
 {
 public:
     AudioEngine(juce::MidiKeyboardState& keyState, juce::MidiMessageCollector& midiCollector, juce::AudioProcessor& associatedProcessor);
@@ -48,6 +55,9 @@ public:
     void addMidiListener(juce::MidiKeyboardState::Listener* newMidiListener);
     void removeMidiListener(juce::MidiKeyboardState::Listener* midiListener);
 
+    void addPlayPath(PlayPath* newPlayPath); //the couriers of registered play paths are moved by the audio thread
+    void removePlayPath(PlayPath* playPath); //must be called before the play path is deleted
+
     juce::Colour getRegionColour(int regionID);
     void changeRegionColour(int regionID, juce::Colour newColour);
 
@@ -56,6 +66,10 @@ public:
     juce::Array<Voice*> getVoicesWithID(int regionID);
     bool checkRegionHasVoice(int regionID);
     void removeVoicesWithID(int regionID);
+    void setRegionPolyphony(int regionID, int polyphony); //replaces the region's voices by the given number of voices with the same parameters and modulations. the region needs to set their file afterwards
+    VoicePool* getVoicePool();
+
+    static const int maxPolyphony;
 
     juce::Array<ModulatableParameter<double>*> getParameterOfRegion_Volume(int regionID);
     juce::Array<ModulatableParameter<double>*> getParameterOfRegion_Pitch(int regionID);
@@ -70,8 +84,9 @@ public:
     juce::Array<ModulatableParameter<double>*> getParameterOfRegion_LfoUpdateInterval(int regionID);
 
     bool updateLfoParameter(int lfoID, int targetRegionID, bool shouldBeModulated, LfoModulatableParameter modulatedParameter);
+    bool getModulatableParametersOfRegion(int regionID, LfoModulatableParameter modulatedParameter, juce::Array<ModulatableParameter<double>*>& parameters); //returns false for unknown parameters
 
-    void prepareToPlay(int /*samplesPerBlockExpected*/, double sampleRate) override;
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void suspendProcessing(bool shouldBeSuspended);
     bool isSuspended();
     void panic();
@@ -80,7 +95,18 @@ public:
 
     void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
 
+    double getSampleRate(); //0.0 while the engine hasn't been prepared yet. message thread
+
+    int getControlRateChunkSize();
+    void setControlRateChunkSize(int newControlRateChunkSize);
+
+    int getNumRenderThreads();
+    void setNumRenderThreads(int newNumRenderThreads); //number of threads that render voices in addition to the audio thread. 0 disables parallel rendering
+    static int getDefaultNumRenderThreads(); //one thread per CPU core, except for the core that the audio thread runs on. also the maximum, since more threads would only compete with the audio thread
+
     juce::Synthesiser* getSynth();
+    SampleStore* getSampleStore();
+    AudioFileLoader* getFileLoader();
 
     void addLfo(RegionLfo* newLfo);
     RegionLfo* getLfo(int regionID);
@@ -93,16 +119,56 @@ private:
     juce::MidiKeyboardState& keyboardState;
     juce::MidiMessageCollector& midiCollector;
     //juce::AudioDeviceManager& deviceManager;
-    juce::Synthesiser synth;
+    MultiCoreSynthesiser synth; //renders independent groups of voices in parallel if there are any render threads
+    juce::MidiBuffer incomingMidi;
+    juce::MidiBuffer injectedMidi;
+
+    juce::Array<PlayPath*> playPaths; //play paths whose couriers are moved in sync with the rendered audio
+    juce::SpinLock playPathLock; //held by the audio thread while moving couriers, and by the message thread while (un)registering play paths
+    int getSamplesUntilNextCourierEvent(int maxSamples);
+    void advanceCouriers(int numSamples);
+
+    juce::uint32 lfoControlStep = 0; //incremented once per sub-block (audio thread)
+    RegionLfoBatch lfoBatch; //calculates the values of all LFOs that updated during a sub-block at once
+    void advanceLfos(int numSamples);
+    int controlRateChunkSize = defaultControlRateChunkSize; //maximum length (in samples) of the sub-blocks that all voices are rendered in
 
     SegmentableImage* associatedImage = nullptr; //image that the editor will display. it's important to save it here, in the AudioEngine, and not in the editor, because otherwise, it would be deleted (and couldn't be restored) whenever the editor closes
 
     int regionIdCounter = -1;
     juce::Array<juce::Colour> regionColours;
     juce::Array<int> takenRegionIDs;
+    SampleStore sampleStore; //every sample is stored once, no matter how many regions and voices use it
+    AudioFileLoader fileLoader; //decodes audio files in the background. shared by all regions
+    VoicePool voicePool; //decides which voices play and steals voices if necessary
+
     juce::OwnedArray<RegionLfo> lfos; //one LFO per segmented region which represents that region's outline in relation to its focus point
 
+    //everything that belongs to a region, so that per-region queries don't need to search through all LFOs and voices
+    struct RegionEntry
+    {
+        RegionLfo* lfo = nullptr; //owned by lfos
+        juce::Array<Voice*> voices; //owned by the synth
+
+        //parameters of all of the region's voices, as handed to modulating LFOs. updated whenever the voices change
+        juce::Array<ModulatableParameter<double>*> volumeParameters;
+        juce::Array<ModulatableParameter<double>*> pitchParameters;
+        juce::Array<ModulatableParameter<double>*> playbackPositionStartParameters;
+        juce::Array<ModulatableParameter<double>*> playbackPositionIntervalParameters;
+        juce::Array<ModulatableParameter<double>*> playbackPositionCurrentParameters;
+        juce::Array<ModulatableParameter<double>*> filterPositionParameters;
+    };
+    juce::OwnedArray<RegionEntry> regionTable; //index: region ID. kept in sync by addLfo/removeLfo, addVoice/removeVoicesWithID and tryChangeRegionID
+    RegionEntry* getRegionEntry(int regionID); //nullptr if there's no entry for this ID
+    RegionEntry* getOrCreateRegionEntry(int regionID);
+    bool isRegionIDTaken(int regionID); //O(1) lookup in the region table. entries that have been created only to fill up the table are free
+    void updateParameterHandles(RegionEntry* entry);
+    std::unique_ptr<ModulationMatrix> modulationMatrix; //compiled form of all modulations. only replaced while holding the synth's lock
+    std::atomic<int> modulationMatrixVersion { 0 };
+    std::atomic<double> preparedSampleRate { 0.0 }; //written by prepareToPlay, read on the message thread
+
     static const int defaultPolyphony;
+    static const int defaultControlRateChunkSize;
 
     bool serialiseImage(juce::XmlElement* xmlAudioEngine, juce::Array<juce::MemoryBlock>* attachedData);
     bool serialiseRegionColours(juce::XmlElement* xmlAudioEngine);
@@ -117,5 +183,10 @@ private:
 
     void resetAll();
 
+    void invalidateModulationGraph(); //must be called *before* voices or LFOs are added or removed, or before the modulations between regions change
+    void handleAsyncUpdate() override;
+    void rebuildVoiceGroups();
+    void rebuildModulationMatrix();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioEngine)
 };
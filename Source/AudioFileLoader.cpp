@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    AudioFileLoader.cpp
+    Created: 17 Oct 2026 4:12:53pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "AudioFileLoader.h"
+
+//constants
+const int AudioFileLoader::defaultNumThreads = 2;
+const int AudioFileLoader::chunkSize = 65536;
+const float AudioFileLoader::progressStep = 0.01f;
+const double AudioFileLoader::streamingThresholdSeconds = 20.0;
+
+
+AudioFileLoader::AudioFileLoader(int numThreads) :
+    threadPool(juce::jmax(1, numThreads)),
+    streamingThread(std::make_shared<juce::TimeSliceThread>("Audio File Streaming"))
+{
+    formatManager.registerBasicFormats();
+    streamingThread->startThread();
+}
+AudioFileLoader::~AudioFileLoader()
+{
+    DBG("destroying AudioFileLoader...");
+
+    activeLoadIDs.clear(); //no more callbacks
+    threadPool.removeAllJobs(true, 5000); //interrupts all jobs and waits for them to exit
+
+    DBG("AudioFileLoader destroyed.");
+}
+
+int AudioFileLoader::loadFile(const juce::File& file, ProgressCallback onProgress, FinishedCallback onFinished, StreamingCallback onStreaming, FailedCallback onFailed)
+{
+    int loadID = nextLoadID++;
+    activeLoadIDs.add(loadID);
+    threadPool.addJob(new LoadJob(*this, loadID, file, onProgress, onFinished, onStreaming, onFailed), true); //the pool deletes the job once it's finished
+
+    DBG("loading " + file.getFullPathName() + " in the background (load #" + juce::String(loadID) + ")...");
+    return loadID;
+}
+void AudioFileLoader::cancel(int loadID)
+{
+    if (!activeLoadIDs.contains(loadID))
+    {
+        return; //already finished or cancelled
+    }
+    activeLoadIDs.removeFirstMatchingValue(loadID); //no more callbacks, even if the job has already posted some
+
+    for (int i = 0; i < threadPool.getNumJobs(); ++i)
+    {
+        auto* job = dynamic_cast<LoadJob*>(threadPool.getJob(i));
+        if (job != nullptr && job->getLoadID() == loadID)
+        {
+            threadPool.removeJob(job, true, 0); //doesn't wait; the job checks shouldExit() between chunks
+            break;
+        }
+    }
+
+    DBG("load #" + juce::String(loadID) + " cancelled.");
+}
+bool AudioFileLoader::isLoading(int loadID)
+{
+    return activeLoadIDs.contains(loadID);
+}
+
+StreamingAudioFile::Ptr AudioFileLoader::openStream(const juce::File& file)
+{
+    juce::AudioFormatReader* reader = nullptr;
+    {
+        const juce::ScopedLock sl(formatManagerLock);
+        reader = formatManager.createReaderFor(file);
+    }
+
+    if (reader == nullptr)
+    {
+        DBG("couldn't open " + file.getFullPathName() + " for streaming.");
+        return nullptr;
+    }
+
+    return new StreamingAudioFile(reader, file, streamingThread); //takes ownership of the reader
+}
+
+juce::String AudioFileLoader::getWildcardForAllFormats()
+{
+    return formatManager.getWildcardForAllFormats();
+}
+
+
+
+
+AudioFileLoader::LoadJob::LoadJob(AudioFileLoader& owner, int loadID, const juce::File& file, ProgressCallback onProgress, FinishedCallback onFinished, StreamingCallback onStreaming, FailedCallback onFailed) :
+    juce::ThreadPoolJob("Load " + file.getFileName()),
+    owner(&owner),
+    loadID(loadID),
+    file(file),
+    onProgress(onProgress),
+    onFinished(onFinished),
+    onStreaming(onStreaming),
+    onFailed(onFailed)
+{ }
+
+juce::ThreadPoolJob::JobStatus AudioFileLoader::LoadJob::runJob()
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(createReader());
+    if (reader == nullptr)
+    {
+        postFailed("The file couldn't be opened. This is most likely because the format isn't supported.");
+        return juce::ThreadPoolJob::jobHasFinished;
+    }
+
+    if (reader->sampleRate <= 0.0 || static_cast<double>(reader->lengthInSamples) / reader->sampleRate > streamingThresholdSeconds
+        || reader->lengthInSamples > static_cast<juce::int64>(std::numeric_limits<int>::max()))
+    {
+        //long file -> stream it from disk instead of decoding it completely. only its head is preloaded here
+        //(the owner can't be deleted while this job is running, see createReader)
+        StreamingAudioFile::Ptr stream = new StreamingAudioFile(reader.release(), file, owner->streamingThread);
+        if (!shouldExit())
+        {
+            postStreaming(stream);
+        }
+        return juce::ThreadPoolJob::jobHasFinished;
+    }
+
+    int numSamples = static_cast<int>(reader->lengthInSamples);
+    auto buffer = std::make_shared<juce::AudioSampleBuffer>(static_cast<int>(reader->numChannels), numSamples);
+    float lastPostedProgress = 0.0f;
+
+    //decode in chunks, so that the load can be cancelled and its progress can be displayed
+    for (int startSample = 0; startSample < numSamples; startSample += chunkSize)
+    {
+        if (shouldExit())
+        {
+            return juce::ThreadPoolJob::jobHasFinished; //cancelled -> no callbacks
+        }
+
+        int numSamplesInChunk = juce::jmin(chunkSize, numSamples - startSample);
+        reader->read(buffer.get(), startSample, numSamplesInChunk, static_cast<juce::int64>(startSample), true, true);
+
+        float progress = static_cast<float>(startSample + numSamplesInChunk) / static_cast<float>(numSamples);
+        if (progress - lastPostedProgress >= progressStep)
+        {
+            postProgress(progress);
+            lastPostedProgress = progress;
+        }
+    }
+
+    postFinished(buffer, reader->sampleRate);
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+int AudioFileLoader::LoadJob::getLoadID()
+{
+    return loadID;
+}
+
+std::unique_ptr<juce::AudioFormatReader> AudioFileLoader::LoadJob::createReader()
+{
+    //the owner can't be deleted while this job is running (its destructor waits for all jobs)
+    const juce::ScopedLock sl(owner->formatManagerLock);
+    return std::unique_ptr<juce::AudioFormatReader>(owner->formatManager.createReaderFor(file));
+}
+
+void AudioFileLoader::LoadJob::postProgress(float progress)
+{
+    auto weakOwner = owner;
+    auto id = loadID;
+    auto callback = onProgress;
+
+    juce::MessageManager::callAsync([weakOwner, id, callback, progress]
+        {
+            if (weakOwner != nullptr && weakOwner->isLoading(id) && callback)
+            {
+                callback(progress);
+            }
+        });
+}
+void AudioFileLoader::LoadJob::postFinished(std::shared_ptr<juce::AudioSampleBuffer> buffer, double sampleRate)
+{
+    auto weakOwner = owner;
+    auto id = loadID;
+    auto callback = onFinished;
+    auto fileName = file.getFileName();
+
+    juce::MessageManager::callAsync([weakOwner, id, callback, buffer, fileName, sampleRate]
+        {
+            if (weakOwner != nullptr && weakOwner->isLoading(id))
+            {
+                weakOwner->activeLoadIDs.removeFirstMatchingValue(id);
+                DBG("load #" + juce::String(id) + " finished.");
+                if (callback)
+                {
+                    callback(*buffer, fileName, sampleRate);
+                }
+            }
+        });
+}
+void AudioFileLoader::LoadJob::postStreaming(StreamingAudioFile::Ptr stream)
+{
+    auto weakOwner = owner;
+    auto id = loadID;
+    auto callback = onStreaming;
+    auto fileName = file.getFileName();
+
+    juce::MessageManager::callAsync([weakOwner, id, callback, stream, fileName]
+        {
+            if (weakOwner != nullptr && weakOwner->isLoading(id))
+            {
+                weakOwner->activeLoadIDs.removeFirstMatchingValue(id);
+                DBG("load #" + juce::String(id) + " finished (streaming).");
+                if (callback)
+                {
+                    callback(stream, fileName);
+                }
+            }
+        });
+}
+void AudioFileLoader::LoadJob::postFailed(const juce::String& errorMessage)
+{
+    auto weakOwner = owner;
+    auto id = loadID;
+    auto callback = onFailed;
+
+    juce::MessageManager::callAsync([weakOwner, id, callback, errorMessage]
+        {
+            if (weakOwner != nullptr && weakOwner->isLoading(id))
+            {
+                weakOwner->activeLoadIDs.removeFirstMatchingValue(id);
+                DBG("load #" + juce::String(id) + " failed: " + errorMessage);
+                if (callback)
+                {
+                    callback(errorMessage);
+                }
+            }
+        });
+}
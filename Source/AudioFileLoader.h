@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    AudioFileLoader.h
+    Created: 17 Oct 2026 4:12:53pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "StreamingAudioFile.h"
+
+/// <summary>
+/// Decodes audio files on a pool of background threads, so that neither the UI nor the audio engine has to wait for them.
+/// Files that are longer than streamingThresholdSeconds aren't decoded completely. Instead, they are streamed from disk (see StreamingAudioFile) by a thread that is owned by the loader.
+/// All callbacks are called on the message thread. After cancel() has been called for a load (or once the loader has been destroyed), none of its callbacks will be called anymore.
+/// </summary>
+class AudioFileLoader
+{
+public:
+    typedef std::function<void(float progress)> ProgressCallback; //progress within [0,1]
+    typedef std::function<void(juce::AudioSampleBuffer& buffer, const juce::String& fileName, double sampleRate)> FinishedCallback;
+    typedef std::function<void(StreamingAudioFile::Ptr stream, const juce::String& fileName)> StreamingCallback; //called instead of FinishedCallback for long files
+    typedef std::function<void(const juce::String& errorMessage)> FailedCallback;
+
+    AudioFileLoader(int numThreads = defaultNumThreads);
+    ~AudioFileLoader();
+
+    /// <summary>
+    /// Starts decoding the given file in the background.
+    /// </summary>
+    /// <returns>ID of the load, which can be passed to cancel()</returns>
+    int loadFile(const juce::File& file, ProgressCallback onProgress, FinishedCallback onFinished, StreamingCallback onStreaming, FailedCallback onFailed);
+    void cancel(int loadID);
+    bool isLoading(int loadID);
+
+    /// <summary>
+    /// Opens the given file for streaming right away (blocks until its head has been preloaded). Used when restoring streamed files.
+    /// </summary>
+    /// <returns>The stream, or nullptr if the file couldn't be opened</returns>
+    StreamingAudioFile::Ptr openStream(const juce::File& file);
+
+    juce::String getWildcardForAllFormats();
+
+private:
+    class LoadJob : public juce::ThreadPoolJob
+    {
+    public:
+        LoadJob(AudioFileLoader& owner, int loadID, const juce::File& file, ProgressCallback onProgress, FinishedCallback onFinished, StreamingCallback onStreaming, FailedCallback onFailed);
+
+        juce::ThreadPoolJob::JobStatus runJob() override;
+
+        int getLoadID();
+
+    private:
+        juce::WeakReference<AudioFileLoader> owner;
+        int loadID;
+        juce::File file;
+        ProgressCallback onProgress;
+        FinishedCallback onFinished;
+        StreamingCallback onStreaming;
+        FailedCallback onFailed;
+
+        std::unique_ptr<juce::AudioFormatReader> createReader();
+        void postProgress(float progress);
+        void postFinished(std::shared_ptr<juce::AudioSampleBuffer> buffer, double sampleRate);
+        void postStreaming(StreamingAudioFile::Ptr stream);
+        void postFailed(const juce::String& errorMessage);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadJob)
+    };
+
+    juce::AudioFormatManager formatManager;
+    juce::CriticalSection formatManagerLock; //creating readers from several threads at once isn't guaranteed to be safe
+    juce::ThreadPool threadPool;
+    std::shared_ptr<juce::TimeSliceThread> streamingThread; //fills the block caches of all streamed files. shared with them, so that it lives as long as the last of them
+
+    int nextLoadID = 0;
+    juce::Array<int> activeLoadIDs; //only accessed on the message thread
+
+    static const int defaultNumThreads;
+    static const int chunkSize; //number of samples decoded between two checks for cancellation
+    static const float progressStep; //minimum change in progress between two progress callbacks
+    static const double streamingThresholdSeconds; //files that are longer than this are streamed instead of being decoded completely
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(AudioFileLoader)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFileLoader)
+};
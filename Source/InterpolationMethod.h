@@ -0,0 +1,19 @@
+/*
+  ==============================================================================
+
+    InterpolationMethod.h
+    Created: 17 Oct 2026 10:12:41am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+enum class InterpolationMethod : int
+{
+    none = 0, //truncates the read position (cheapest, but aliases)
+    linear,
+    cubic, //4-point Hermite
+    windowedSinc //8-point Blackman-windowed sinc (most expensive)
+};
@@ -289,6 +289,11 @@ void LfoEditor::randomiseAllParameters()
 void LfoEditor::updateLfoRate()
 {
     associatedLfo->setBaseFrequency(lfoRateSlider.getValue());
+
+    if (onRateChanged != nullptr)
+    {
+        onRateChanged();
+    }
 }
 void LfoEditor::randomiseLfoRate()
 {
@@ -346,6 +351,11 @@ void LfoEditor::updateLfoUpdateInterval()
 {
     associatedLfo->setUpdateInterval_Milliseconds(static_cast<float>(lfoUpdateIntervalSlider.getValue()));
     static_cast<RegionEditor*>(getParentComponent())->getAssociatedRegion()->setTimerInterval(static_cast<int>(lfoUpdateIntervalSlider.getValue()));
+
+    if (onRateChanged != nullptr)
+    {
+        onRateChanged(); //the update interval limits the harmonics that the LFO can reproduce
+    }
 }
 void LfoEditor::randomiseLfoUpdateInterval()
 {
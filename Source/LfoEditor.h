@@ -37,6 +37,8 @@ public:
 
     void randomiseAllParameters();
 
+    std::function<void()> onRateChanged; //called whenever the LFO's base frequency or update interval has been changed via their sliders
+
 private:
     AudioEngine* audioEngine;
     RegionLfo* associatedLfo;
@@ -11,55 +11,67 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <limits>
 
-#include "ModulatableParameterStateIndex.h"
-#include "ModulatableParameterStates.h"
+//#include "RegionLfo.h" //do NOT include this! since RegionLfo has a ModulatableAdditiveParameter member and including RegionLfo's header would require ModulatableAdditiveParameter<double> to already have been initialised, that creates a cyclic compilation error!
+class RegionLfo; //this is enough for ModulatableParameter to be compiled since it only needs pointers to RegionLfo (-> known size in memory) and no methods
+
+/// <summary>
+/// Modulation policy of parameters where the individual modulators' values add up.
+/// </summary>
+/// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
-class ModulatableParameterState;
+struct AdditiveModulationPolicy
+{
+    static constexpr bool isMultiplicative = false;
+    static constexpr bool hasLowerCap = false;
+};
+
+/// <summary>
+/// Modulation policy of parameters where the individual modulators' values are multiplied.
+/// </summary>
+/// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
-class ModulatableParameterState_Outdated;
+struct MultiplicativeModulationPolicy
+{
+    static constexpr bool isMultiplicative = true;
+    static constexpr bool hasLowerCap = false;
+};
+
+/// <summary>
+/// Modulation policy of parameters where the individual modulators' values are multiplied and the result mustn't fall below a lower cap.
+/// </summary>
+/// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
-class ModulatableParameterState_UpToDate;
+struct MultiplicativeLowerCapModulationPolicy
+{
+    static constexpr bool isMultiplicative = true;
+    static constexpr bool hasLowerCap = true;
+};
+
+
 
-//#include "RegionLfo.h" //do NOT include this! since RegionLfo has a ModulatableAdditiveParameter member and including RegionLfo's header would require ModulatableAdditiveParameter<double> to already have been initialised, that creates a cyclic compilation error!
-class RegionLfo; //this is enough for ModulatableParameter to be compiled since it only needs pointers to RegionLfo (-> known size in memory) and no methods
 
 /// <summary>
 /// Wrapper class for modulatable parameters. Contains the parameter's base value as well as the current modulated value.
 /// It also contains a modulator list to / from which LFOs can add / remove themselves.
 /// This ultimately saves some CPU ressources as the modulated value only gets updated when any of the LFOs update(instead of being updated during every sample).
+///
+/// The parameter doesn't use any virtual calls or heap-allocated states: whether the modulated value is outdated is a plain flag, and the way that the modulators
+/// are combined is described by a few numbers (see combine and evaluate), so that the ModulationMatrix can evaluate many parameters of different kinds in one loop.
+/// The lazy recalculation (only needed if the base value or the list of modulators changes) uses the same inlined functions.
 /// </summary>
 /// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
 class ModulatableParameter
 {
 public:
-    ModulatableParameter(T baseValue) :
-        baseValue(baseValue)
-    {
-        currentModulatedValue = baseValue;
-
-        //prepare states
-        states[static_cast<int>(ModulatableParameterStateIndex::outdated)] = static_cast<ModulatableParameterState<T>*>(new ModulatableParameterState_Outdated<T>(*this));
-        states[static_cast<int>(ModulatableParameterStateIndex::upToDate)] = static_cast<ModulatableParameterState<T>*>(new ModulatableParameterState_UpToDate<T>(*this));
-        int initialisedStates = 2;
-        jassert(initialisedStates == static_cast<int>(ModulatableParameterStateIndex::StateIndexCount));
+    typedef double(*lfoEvalFuncPt)(RegionLfo* lfo); //pointer to a function that evaluates the current value of an LFO
 
-        currentStateIndex = initialStateIndex;
-        currentState = states[static_cast<int>(currentStateIndex)];
-    }
     ~ModulatableParameter()
     {
         DBG("destroying ModulatableParameter...");
 
-        //release states
-        currentState = nullptr;
-        delete states[static_cast<int>(ModulatableParameterStateIndex::outdated)];
-        delete states[static_cast<int>(ModulatableParameterStateIndex::upToDate)];
-        int deletedStates = 2;
-        jassert(deletedStates == static_cast<int>(ModulatableParameterStateIndex::StateIndexCount));
-
-        //rest
         modulatingLfos.clear();
         modulatingRegionIDs.clear();
         lfoEvaluationFunctions.clear();
@@ -67,8 +79,6 @@ public:
         DBG("ModulatableParameter destroyed.");
     }
 
-    typedef double(*lfoEvalFuncPt)(RegionLfo* lfo); //pointer to a function that evaluates the current value of an LFO
-
     void addModulator(RegionLfo* newModulatingLfo, int newRegionID, lfoEvalFuncPt newEvalFuncPt)
     {
         for (auto* it = modulatingRegionIDs.begin(); it != modulatingRegionIDs.end(); it++)
@@ -84,7 +94,7 @@ public:
         modulatingLfos.add(newModulatingLfo);
         modulatingRegionIDs.add(newRegionID);
         lfoEvaluationFunctions.add(newEvalFuncPt);
-        transitionToState(ModulatableParameterStateIndex::outdated);
+        isOutdated = true;
     }
     void removeModulator(int regionID)
     {
@@ -97,7 +107,7 @@ public:
                 modulatingLfos.remove(i);
                 modulatingRegionIDs.remove(i);
                 lfoEvaluationFunctions.remove(i);
-                transitionToState(ModulatableParameterStateIndex::outdated);
+                isOutdated = true;
                 return;
             }
         }
@@ -118,65 +128,117 @@ public:
     void setBaseValue(T newBaseValue)
     {
         baseValue = newBaseValue;
-        transitionToState(ModulatableParameterStateIndex::outdated);
+        isOutdated = true;
     }
 
     T getModulatedValue()
     {
-        currentState->ensureModulatorIsUpToDate(); //re-calculates the modulated value if it's outdated
+        if (isOutdated)
+        {
+            calculateModulatedValue(); //rare: only after the base value or the modulators have changed
+        }
         return currentModulatedValue;
     }
-    void signalModulatorUpdated() //transitions into a pending state, so that next time getModulatedValue() is called, currentModulatedValue is re-calculated
+    void signalModulatorUpdated() //marks the modulated value as outdated, so that next time getModulatedValue() is called, currentModulatedValue is re-calculated
     {
-        //transitionToState(ModulatableParameterStateIndex::outdated);
-        currentState->modulatorHasUpdated(); //should be sliiiightly quicker than the line above, because for the outdated state, this function is empty. and since this function will be called several times during the outdated state except if there's only 1 modulator, it'll be more efficient. and if there's only 1 modulator, not a lot of CPU is used anyway.
+        isOutdated = true;
     }
 
     /// <summary>
-    /// If the parameter is currently outdated, it will recalculate the modulated value and set the passed variable to the new modulated value. If it's up-to-date, the passed variable will remain unchanged.
+    /// If the modulated value has changed since the last call (because it was outdated or because the ModulationMatrix has applied a new modulation), sets the passed variable to the new modulated value.
+    /// Otherwise, the passed variable will remain unchanged.
     /// </summary>
-    /// <param name="valueToModulate">The variable that will be adjusted if the parameter is outdated</param>
+    /// <param name="valueToModulate">The variable that will be adjusted if the modulated value has changed</param>
     /// <returns>True if the variable got updated, false if it remained the same.</returns>
     bool modulateValueIfUpdated(T* valueToModulate) //used primarily for modulating the current LFO phase and audio playback position
     {
-        return currentState->modulateValueIfUpdated(valueToModulate);
+        if (isOutdated)
+        {
+            calculateModulatedValue();
+        }
+        else if (!hasPendingModulation)
+        {
+            return false;
+        }
+
+        *valueToModulate = currentModulatedValue;
+        hasPendingModulation = false;
+        return true;
     }
 
-    void transitionToState(ModulatableParameterStateIndex stateToTransitionTo)
+    /// <summary>
+    /// Recalculates the modulated value from the base value and the current values of all modulators.
+    /// </summary>
+    void calculateModulatedValue()
     {
-        //states cannot be skipped here, so in contrast to the state implementation of RegionLfo or the DAHDSR envelope and such, no while-loop is needed here
-        switch (stateToTransitionTo)
+        T combinedModulation = multiplicativeWeight; //identity: 0 for additive, 1 for multiplicative parameters
+
+        auto* itFunc = lfoEvaluationFunctions.begin();
+        for (auto* itLfo = modulatingLfos.begin(); itLfo != modulatingLfos.end(); itLfo++, itFunc++)
         {
-        case ModulatableParameterStateIndex::outdated:
-            //DBG("parameter outdated");
-            break;
+            combinedModulation = combine(combinedModulation, static_cast<T>((*itFunc)(*itLfo)), multiplicativeWeight); //the evaluation function handles unipolar vs. bipolar values, scalings, inversions, etc.
+        }
 
-        case ModulatableParameterStateIndex::upToDate:
-            //DBG("parameter up-to-date")
-            break;
+        currentModulatedValue = evaluate(baseValue, combinedModulation, multiplicativeWeight, lowerCap);
+        isOutdated = false;
+        hasPendingModulation = false; //the value has been requested directly
+    }
 
-        default:
-            throw std::exception("unhandled state index");
-        }
+    /// <summary>
+    /// Sets a modulated value that has already been evaluated elsewhere (e.g. by the ModulationMatrix for many parameters at once, using evaluate()).
+    /// </summary>
+    void setModulatedValue(T newModulatedValue)
+    {
+        currentModulatedValue = newModulatedValue;
+        isOutdated = false;
+        hasPendingModulation = true;
+    }
 
-        //finally, update the current state index
-        currentStateIndex = stateToTransitionTo;
-        currentState = states[static_cast<int>(currentStateIndex)];
+    /// <summary>
+    /// Branch-free combination of the accumulated modulation with the value of one more modulator:
+    /// additive parameters (multiplicativeWeight 0) add it, multiplicative ones (multiplicativeWeight 1) multiply it.
+    /// </summary>
+    static T combine(T accumulatedModulation, T modulation, T multiplicativeWeight)
+    {
+        T additiveWeight = static_cast<T>(1) - multiplicativeWeight;
+        return accumulatedModulation * (multiplicativeWeight * modulation + additiveWeight) + additiveWeight * modulation;
+    }
+    /// <summary>
+    /// Branch-free evaluation of a modulated value, valid for all kinds of parameters:
+    /// additive parameters (multiplicativeWeight 0) evaluate to base + modulation, multiplicative ones (multiplicativeWeight 1) to base * modulation.
+    /// The result is never lower than lowerCap (which is the lowest possible value for parameters without a cap).
+    /// </summary>
+    static T evaluate(T base, T combinedModulation, T multiplicativeWeight, T lowerCap)
+    {
+        T additiveWeight = static_cast<T>(1) - multiplicativeWeight;
+        return juce::jmax(lowerCap, base * (multiplicativeWeight * combinedModulation + additiveWeight) + additiveWeight * combinedModulation);
     }
 
-    T currentModulatedValue; //required to be public for the implementation of the states - exclusively use getModulatedValue otherwise!
-    virtual void calculateModulatedValue() = 0;
+    T getMultiplicativeWeight() //determines how the ModulationMatrix combines the values of several modulators
+    {
+        return multiplicativeWeight;
+    }
+    T getLowerCap()
+    {
+        return lowerCap;
+    }
 
 protected:
-    //states
-    ModulatableParameterState<T>* states[static_cast<int>(ModulatableParameterStateIndex::StateIndexCount)]; //fixed size -> more efficient access
-
-    static const ModulatableParameterStateIndex initialStateIndex = ModulatableParameterStateIndex::outdated;
-    ModulatableParameterStateIndex currentStateIndex;
-    ModulatableParameterState<T>* currentState = nullptr; //ensures one less if case when accessing the modulated value
+    ModulatableParameter(T baseValue, T multiplicativeWeight, T lowerCap) :
+        baseValue(baseValue),
+        currentModulatedValue(baseValue),
+        multiplicativeWeight(multiplicativeWeight),
+        lowerCap(lowerCap)
+    { }
 
-    //other
     T baseValue;
+    T currentModulatedValue;
+    bool isOutdated = true; //the modulated value needs to be recalculated before it's accessed
+    bool hasPendingModulation = false; //the ModulationMatrix has set a new value that modulateValueIfUpdated hasn't passed on yet
+
+    //description of the policy
+    T multiplicativeWeight; //0 for additive, 1 for multiplicative parameters. also the identity of the combined modulation
+    T lowerCap;
 
     juce::Array<RegionLfo*> modulatingLfos;
     juce::Array<int> modulatingRegionIDs;
@@ -187,123 +249,48 @@ protected:
 
 
 /// <summary>
-/// Implements additive parameters, i.e. parameters where the individual modulators' values add up.
-/// Example: pitch shift(final pitch shift = base pitch shift + pitch shift 1 + pitch shift 2 + ...)
+/// ModulatableParameter whose modulation is specialised by a policy at compile time.
+/// The policy is translated into the numbers that describe it in the base class, since the ModulationMatrix needs to handle parameters of all policies alike.
 /// </summary>
 /// <typeparam name="T">Type of the modulated parameter</typeparam>
-template <typename T>
-class ModulatableAdditiveParameter final : public ModulatableParameter<T>
+/// <typeparam name="Policy">AdditiveModulationPolicy, MultiplicativeModulationPolicy or MultiplicativeLowerCapModulationPolicy</typeparam>
+template <typename T, template <typename> class Policy>
+class PolicyModulatableParameter final : public ModulatableParameter<T>
 {
 public:
-    ModulatableAdditiveParameter(T baseValue) :
-        ModulatableParameter<T>::ModulatableParameter(baseValue)
-    { }
-    /*~ModulatableAdditiveParameter() //<- IMPORTANT: this caused some problems with the deletion of some scalars for some reason. luckily it's not needed atm, but if it ever is, look into that issue further.
+    PolicyModulatableParameter(T baseValue) :
+        ModulatableParameter<T>::ModulatableParameter(baseValue,
+                                                      Policy<T>::isMultiplicative ? static_cast<T>(1) : static_cast<T>(0),
+                                                      std::numeric_limits<T>::lowest())
     {
-        ModulatableParameter<T>::~ModulatableParameter<T>();
-    }*/
-
-    void calculateModulatedValue() override
+        static_assert(!Policy<T>::hasLowerCap, "parameters with a lower cap need to be constructed with one");
+    }
+    PolicyModulatableParameter(T baseValue, T lowerCap) :
+        ModulatableParameter<T>::ModulatableParameter(baseValue,
+                                                      Policy<T>::isMultiplicative ? static_cast<T>(1) : static_cast<T>(0),
+                                                      lowerCap)
     {
-        currentModulatedValue = baseValue;
-
-        auto* itFunc = lfoEvaluationFunctions.begin();
-        for (auto* itLfo = modulatingLfos.begin(); itLfo != modulatingLfos.end(); itLfo++, itFunc++)
-        {
-            currentModulatedValue += (*itFunc)(*itLfo); //handles unipolar vs. bipolar values, scalings, inversions, etc.
-        }
-
-        //parameter is now up-to-date again
-        transitionToState(ModulatableParameterStateIndex::upToDate);
+        static_assert(Policy<T>::hasLowerCap, "only parameters with a lower cap can be constructed with one");
     }
 };
 
-
-
+/// <summary>
+/// Implements additive parameters, i.e. parameters where the individual modulators' values add up.
+/// Example: pitch shift(final pitch shift = base pitch shift + pitch shift 1 + pitch shift 2 + ...)
+/// </summary>
+template <typename T>
+using ModulatableAdditiveParameter = PolicyModulatableParameter<T, AdditiveModulationPolicy>;
 
 /// <summary>
 /// Implements multiplicative parameters, i.e. parameters where the individual modulators' values are multiplied.
 /// Example: volume(final volume = base volume * volume 1 * volume 2 * ...)
 /// </summary>
-/// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
-class ModulatableMultiplicativeParameter final : public ModulatableParameter<T>
-{
-public:
-    ModulatableMultiplicativeParameter(T baseValue) :
-        ModulatableParameter<T>::ModulatableParameter(baseValue)
-    { }
-    /*~ModulatableMultiplicativeParameter() //<- IMPORTANT: this caused some problems with the deletion of some scalars for some reason. luckily it's not needed atm, but if it ever is, look into that issue further.
-    {
-        ModulatableParameter<T>::~ModulatableParameter<T>();
-    }*/
-
-    void calculateModulatedValue() override
-    {
-        currentModulatedValue = baseValue;
-
-        //DBG("base " + juce::String(baseValue));
-
-        auto* itFunc = lfoEvaluationFunctions.begin();
-        for (auto* itLfo = modulatingLfos.begin(); itLfo != modulatingLfos.end(); itLfo++, itFunc++)
-        {
-            currentModulatedValue *= (*itFunc)(*itLfo); //handles unipolar vs. bipolar values, scalings, inversions, etc.
-            //DBG("*" + juce::String((*itFunc)(*itLfo)));
-        }
-
-        //DBG("mod val: " + juce::String(currentModulatedValue));
-
-        //parameter is now up-to-date again
-        transitionToState(ModulatableParameterStateIndex::upToDate);
-    }
-};
-
-
-
+using ModulatableMultiplicativeParameter = PolicyModulatableParameter<T, MultiplicativeModulationPolicy>;
 
 /// <summary>
 /// Implements multiplicative parameters, i.e. parameters where the individual modulators' values are multiplied. The parameter has a lower cap.
-/// Example: volume(final volume = base volume * volume 1 * volume 2 * ...)
+/// Example: playback interval(final interval = base interval * interval 1 * interval 2 * ..., but never 0)
 /// </summary>
-/// <typeparam name="T">Type of the modulated parameter</typeparam>
 template <typename T>
-class ModulatableMultiplicativeParameterLowerCap final : public ModulatableParameter<T>
-{
-public:
-    ModulatableMultiplicativeParameterLowerCap(T baseValue, T lowerCap) :
-        ModulatableParameter<T>::ModulatableParameter(baseValue)
-    {
-        this->lowerCap = lowerCap;
-    }
-    /*~ModulatableMultiplicativeParameterLowerCap() //<- IMPORTANT: this caused some problems with the deletion of some scalars for some reason. luckily it's not needed atm, but if it ever is, look into that issue further.
-    {
-        ModulatableParameter<T>::~ModulatableParameter<T>();
-    }*/
-
-    void calculateModulatedValue() override
-    {
-        currentModulatedValue = baseValue;
-
-        //DBG("base " + juce::String(baseValue));
-
-        auto* itFunc = lfoEvaluationFunctions.begin();
-        for (auto* itLfo = modulatingLfos.begin(); itLfo != modulatingLfos.end(); itLfo++, itFunc++)
-        {
-            currentModulatedValue *= (*itFunc)(*itLfo); //handles unipolar vs. bipolar values, scalings, inversions, etc.
-            //DBG("*" + juce::String((*itFunc)(*itLfo)));
-        }
-
-        if (currentModulatedValue < lowerCap)
-        {
-            currentModulatedValue = lowerCap;
-        }
-
-        //DBG("mod val: " + juce::String(currentModulatedValue));
-
-        //parameter is now up-to-date again
-        transitionToState(ModulatableParameterStateIndex::upToDate);
-    }
-
-private:
-    T lowerCap;
-};
+using ModulatableMultiplicativeParameterLowerCap = PolicyModulatableParameter<T, MultiplicativeLowerCapModulationPolicy>;
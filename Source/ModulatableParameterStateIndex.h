@@ -1,18 +0,0 @@
-/*
-  ==============================================================================
-
-    ModulatableParameterStateIndex.h
-    Created: 21 Sep 2022 9:26:27am
-    Author:  Aaron
-
-  ==============================================================================
-*/
-
-#pragma once
-
-enum class ModulatableParameterStateIndex : int
-{
-    outdated = 0,
-    upToDate,
-    StateIndexCount
-};
\ No newline at end of file
@@ -0,0 +1,431 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.cpp
+    Created: 17 Oct 2026 1:21:44pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "ModulationMatrix.h"
+
+ModulationMatrix::ModulationMatrix(const juce::OwnedArray<RegionLfo>& lfos, int version) :
+    version(version)
+{
+    int numLfos = lfos.size();
+
+    //determine which LFOs modulate which other LFOs
+    juce::Array<juce::Array<int>> lfoEdges; //for each LFO: indices of all LFOs that it modulates (may include itself)
+    juce::Array<int> inDegrees;
+    inDegrees.insertMultiple(0, 0, numLfos);
+
+    for (int a = 0; a < numLfos; ++a)
+    {
+        lfoEdges.add(juce::Array<int>());
+
+        auto modulatedParameterIDs = lfos[a]->getModulatedParameterIDs();
+        auto affectedRegionIDs = lfos[a]->getAffectedRegionIDs();
+        for (int m = 0; m < modulatedParameterIDs.size(); ++m)
+        {
+            if (!isLfoParameter(modulatedParameterIDs[m]))
+            {
+                continue; //voice parameters don't have any outgoing links
+            }
+
+            for (int b = 0; b < numLfos; ++b)
+            {
+                if (lfos[b]->getRegionID() == affectedRegionIDs[m])
+                {
+                    if (lfoEdges.getReference(a).addIfNotAlreadyThere(b))
+                    {
+                        inDegrees.set(b, inDegrees[b] + 1);
+                    }
+                    break; //only one LFO per region
+                }
+            }
+        }
+    }
+
+    //sort topologically (Kahn's algorithm). ties and cycles are resolved by picking the LFO with the lowest region ID, so the order is deterministic.
+    juce::Array<int> ranks; //position of each LFO within the order
+    ranks.insertMultiple(0, -1, numLfos);
+
+    for (int rank = 0; rank < numLfos; ++rank)
+    {
+        int next = -1;
+        int nextInCycle = -1; //fallback if all remaining LFOs are part of (or depend on) a cycle
+
+        for (int i = 0; i < numLfos; ++i)
+        {
+            if (ranks[i] >= 0)
+            {
+                continue; //already sorted
+            }
+
+            if (inDegrees[i] == 0 && (next < 0 || lfos[i]->getRegionID() < lfos[next]->getRegionID()))
+            {
+                next = i;
+            }
+            if (nextInCycle < 0 || lfos[i]->getRegionID() < lfos[nextInCycle]->getRegionID())
+            {
+                nextInCycle = i;
+            }
+        }
+
+        if (next < 0)
+        {
+            next = nextInCycle; //break the cycle here
+            DBG("ModulationMatrix: feedback cycle found. breaking it at the LFO of region " + juce::String(lfos[next]->getRegionID()));
+        }
+
+        ranks.set(next, rank);
+        for (int b : lfoEdges[next])
+        {
+            inDegrees.set(b, inDegrees[b] - 1);
+        }
+    }
+
+    //levels: an LFO lies above all LFOs that modulate it via non-feedback links (longest path, following the topological order)
+    juce::Array<int> lfosByRank;
+    lfosByRank.insertMultiple(0, -1, numLfos);
+    for (int i = 0; i < numLfos; ++i)
+    {
+        lfosByRank.set(ranks[i], i);
+    }
+
+    juce::Array<int> levels;
+    levels.insertMultiple(0, 0, numLfos);
+    int numLevels = numLfos > 0 ? 1 : 0;
+    for (int a : lfosByRank)
+    {
+        for (int b : lfoEdges[a])
+        {
+            if (ranks[b] > ranks[a]) //edges to LFOs that come before (or are) the source are feedback
+            {
+                levels.set(b, juce::jmax(levels[b], levels[a] + 1));
+                numLevels = juce::jmax(numLevels, levels[b] + 1);
+            }
+        }
+    }
+
+    //sources (sorted by level, and by rank within each level)
+    for (int level = 0; level < numLevels; ++level)
+    {
+        levelStarts.add(sourceLfos.size());
+        for (int i : lfosByRank)
+        {
+            if (levels[i] == level)
+            {
+                sourceLfos.add(lfos[i]);
+            }
+        }
+    }
+    levelStarts.add(sourceLfos.size());
+
+    sourceUpdateCount.insertMultiple(0, 0, numLfos);
+    sourceUnipolar.insertMultiple(0, 0.0, numLfos);
+    sourceBipolar.insertMultiple(0, 0.0, numLfos);
+    sourceDepth.insertMultiple(0, 0.0, numLfos);
+
+    //links and targets, grouped by the targets (group 0: voices' parameters, group 1 + n: parameters of the LFOs of level n)
+    int numGroups = numLevels + 1;
+    for (int group = 0; group < numGroups; ++group)
+    {
+        groupTargetStarts.add(targetParameters.size());
+        groupLinkStarts.add(linkSources.size());
+
+        for (int s = 0; s < numLfos; ++s)
+        {
+            auto* lfo = sourceLfos[s];
+            int sourceLevel = levels[lfos.indexOf(lfo)];
+            auto modulatedParameterIDs = lfo->getModulatedParameterIDs();
+            auto affectedRegionIDs = lfo->getAffectedRegionIDs();
+
+            for (int m = 0; m < modulatedParameterIDs.size(); ++m)
+            {
+                int targetGroup = 0;
+                if (isLfoParameter(modulatedParameterIDs[m]))
+                {
+                    for (int i = 0; i < numLfos; ++i)
+                    {
+                        if (lfos[i]->getRegionID() == affectedRegionIDs[m])
+                        {
+                            targetGroup = 1 + levels[i];
+                            break;
+                        }
+                    }
+                }
+                if (targetGroup != group)
+                {
+                    continue;
+                }
+
+                bool isFeedback = targetGroup > 0 && targetGroup - 1 <= sourceLevel; //the source is only advanced after the target has been modulated
+
+                auto parameters = lfo->getModulatedParameters(m);
+                for (auto* parameter : parameters)
+                {
+                    int targetIndex = targetParameters.indexOf(parameter);
+                    if (targetIndex < 0)
+                    {
+                        targetIndex = targetParameters.size();
+                        targetParameters.add(parameter);
+                        targetMultiplicativeWeight.add(parameter->getMultiplicativeWeight());
+                        targetLowerCap.add(parameter->getLowerCap());
+                    }
+
+                    linkSources.add(s);
+                    linkTargets.add(targetIndex);
+                    linkOps.add(getEvalOp(modulatedParameterIDs[m]));
+                    addLinkCoefficients(linkOps.getLast());
+                    numFeedbackLinks += isFeedback ? 1 : 0;
+                }
+            }
+        }
+    }
+    groupTargetStarts.add(targetParameters.size());
+    groupLinkStarts.add(linkSources.size());
+    groupSeenUpdateCount.insertMultiple(0, 0, numGroups);
+
+    targetDirty.insertMultiple(0, false, targetParameters.size());
+    targetCombinedModulation.insertMultiple(0, 0.0, targetParameters.size());
+    targetBaseValue.insertMultiple(0, 0.0, targetParameters.size());
+    targetModulatedValue.insertMultiple(0, 0.0, targetParameters.size());
+    linkSeenUpdateCount.insertMultiple(0, 0, linkSources.size());
+    linkValue.insertMultiple(0, 0.0, linkSources.size());
+
+    DBG("ModulationMatrix compiled: " + juce::String(numLfos) + " sources on " + juce::String(numLevels) + " levels, " + juce::String(targetParameters.size()) + " targets, " + juce::String(linkSources.size()) + " links (" + juce::String(numFeedbackLinks) + " feedback)");
+}
+ModulationMatrix::~ModulationMatrix()
+{
+    //nothing is owned by the matrix
+}
+
+void ModulationMatrix::process()
+{
+    gatherSources();
+    evaluateGroup(0);
+}
+
+int ModulationMatrix::getNumLevels()
+{
+    return levelStarts.size() - 1;
+}
+int ModulationMatrix::getLevelStart(int level)
+{
+    return levelStarts[level];
+}
+RegionLfo* ModulationMatrix::getSource(int index)
+{
+    return sourceLfos[index];
+}
+void ModulationMatrix::processLfoLevel(int level)
+{
+    gatherSources(); //includes the values that the LFOs of the lower levels have just reached
+    evaluateGroup(1 + level);
+}
+
+void ModulationMatrix::gatherSources()
+{
+    int numSources = sourceLfos.size();
+    juce::uint32* updateCount = sourceUpdateCount.getRawDataPointer();
+    double* unipolar = sourceUnipolar.getRawDataPointer();
+    double* bipolar = sourceBipolar.getRawDataPointer();
+    double* depth = sourceDepth.getRawDataPointer();
+
+    for (int s = 0; s < numSources; ++s)
+    {
+        auto* lfo = sourceLfos.getUnchecked(s);
+        if (lfo->checkAndResetUpdated())
+        {
+            ++updateCount[s];
+            ++totalUpdateCount;
+        }
+
+        unipolar[s] = lfo->getCurrentValue_Unipolar();
+        bipolar[s] = lfo->getCurrentValue_Bipolar();
+        depth[s] = static_cast<double>(lfo->getDepth());
+    }
+}
+
+void ModulationMatrix::evaluateGroup(int group)
+{
+    if (groupSeenUpdateCount[group] == totalUpdateCount)
+    {
+        return; //no source has updated since the group was last evaluated (the most common case with longer update intervals)
+    }
+    groupSeenUpdateCount.set(group, totalUpdateCount);
+
+    //evaluate the group's links (no branches -> vectorisable apart from the gathering of the source values)
+    int linkStart = groupLinkStarts[group];
+    int linkEnd = groupLinkStarts[group + 1];
+    const juce::uint32* updateCount = sourceUpdateCount.getRawDataPointer();
+    const double* unipolar = sourceUnipolar.getRawDataPointer();
+    const double* bipolar = sourceBipolar.getRawDataPointer();
+    const double* depth = sourceDepth.getRawDataPointer();
+    const int* sources = linkSources.getRawDataPointer();
+    const int* targets = linkTargets.getRawDataPointer();
+    const double* offset = linkOffset.getRawDataPointer();
+    const double* depthOffset = linkDepthOffset.getRawDataPointer();
+    const double* unipolarScale = linkUnipolarScale.getRawDataPointer();
+    const double* bipolarScale = linkBipolarScale.getRawDataPointer();
+    juce::uint32* seenUpdateCount = linkSeenUpdateCount.getRawDataPointer();
+    double* value = linkValue.getRawDataPointer();
+
+    for (int l = linkStart; l < linkEnd; ++l)
+    {
+        int s = sources[l];
+        value[l] = offset[l] + depth[s] * (depthOffset[l] + unipolarScale[l] * unipolar[s] + bipolarScale[l] * bipolar[s]);
+    }
+
+    //combine the links of every parameter. additive parameters (weight 0) sum up, multiplicative ones (weight 1) multiply
+    int targetStart = groupTargetStarts[group];
+    int targetEnd = groupTargetStarts[group + 1];
+    const double* multiplicativeWeight = targetMultiplicativeWeight.getRawDataPointer();
+    const double* lowerCap = targetLowerCap.getRawDataPointer();
+    bool* dirty = targetDirty.getRawDataPointer();
+    double* combined = targetCombinedModulation.getRawDataPointer();
+    double* baseValue = targetBaseValue.getRawDataPointer();
+    double* modulatedValue = targetModulatedValue.getRawDataPointer();
+
+    for (int t = targetStart; t < targetEnd; ++t)
+    {
+        dirty[t] = false;
+        combined[t] = multiplicativeWeight[t]; //identity: 0.0 for additive, 1.0 for multiplicative parameters
+        baseValue[t] = targetParameters.getUnchecked(t)->getBaseValue();
+    }
+    for (int l = linkStart; l < linkEnd; ++l)
+    {
+        int t = targets[l];
+        combined[t] = ModulatableParameter<double>::combine(combined[t], value[l], multiplicativeWeight[t]);
+        dirty[t] |= seenUpdateCount[l] != updateCount[sources[l]]; //the source has updated since this link was last evaluated
+        seenUpdateCount[l] = updateCount[sources[l]];
+    }
+
+    //evaluate the group's parameters (vectorisable)
+    for (int t = targetStart; t < targetEnd; ++t)
+    {
+        modulatedValue[t] = ModulatableParameter<double>::evaluate(baseValue[t], combined[t], multiplicativeWeight[t], lowerCap[t]);
+    }
+
+    //apply to those parameters whose modulators have updated
+    for (int t = targetStart; t < targetEnd; ++t)
+    {
+        if (dirty[t])
+        {
+            targetParameters.getUnchecked(t)->setModulatedValue(modulatedValue[t]);
+        }
+    }
+}
+
+void ModulationMatrix::addLinkCoefficients(EvalOp op)
+{
+    //value = offset + depth * (depthOffset + unipolarScale * unipolar + bipolarScale * bipolar)
+    switch (op)
+    {
+    case EvalOp::unipolar: //1.0 - depth * (1.0 - unipolar)
+        linkOffset.add(1.0);
+        linkDepthOffset.add(-1.0);
+        linkUnipolarScale.add(1.0);
+        linkBipolarScale.add(0.0);
+        break;
+
+    case EvalOp::unipolarInverted: //1.0 - depth * unipolar
+        linkOffset.add(1.0);
+        linkDepthOffset.add(0.0);
+        linkUnipolarScale.add(-1.0);
+        linkBipolarScale.add(0.0);
+        break;
+
+    case EvalOp::bipolarSemitones: //12.0 * bipolar * depth (12.0: one octave)
+        linkOffset.add(0.0);
+        linkDepthOffset.add(0.0);
+        linkUnipolarScale.add(0.0);
+        linkBipolarScale.add(12.0);
+        break;
+
+    case EvalOp::bipolarSemitonesInverted: //-12.0 * bipolar * depth
+        linkOffset.add(0.0);
+        linkDepthOffset.add(0.0);
+        linkUnipolarScale.add(0.0);
+        linkBipolarScale.add(-12.0);
+        break;
+
+    default:
+        throw std::exception("unhandled evaluation operation");
+    }
+}
+
+int ModulationMatrix::getVersion()
+{
+    return version;
+}
+int ModulationMatrix::getNumLinks()
+{
+    return linkSources.size();
+}
+int ModulationMatrix::getNumFeedbackLinks()
+{
+    return numFeedbackLinks;
+}
+
+ModulationMatrix::EvalOp ModulationMatrix::getEvalOp(LfoModulatableParameter modulatedParameterID)
+{
+    //must match the evaluation functions in RegionLfo::addRegionModulation
+    switch (modulatedParameterID)
+    {
+    case LfoModulatableParameter::volume:
+    case LfoModulatableParameter::playbackPositionStart:
+    case LfoModulatableParameter::playbackPositionInterval:
+    case LfoModulatableParameter::playbackPositionCurrent:
+    case LfoModulatableParameter::filterPosition:
+    case LfoModulatableParameter::lfoStartingPhase:
+    case LfoModulatableParameter::lfoPhaseInterval:
+    case LfoModulatableParameter::lfoCurrentPhase:
+    case LfoModulatableParameter::lfoUpdateInterval:
+        return EvalOp::unipolar;
+
+    case LfoModulatableParameter::volume_inverted:
+    case LfoModulatableParameter::playbackPositionStart_inverted:
+    case LfoModulatableParameter::playbackPositionInterval_inverted:
+    case LfoModulatableParameter::playbackPositionCurrent_inverted:
+    case LfoModulatableParameter::filterPosition_inverted:
+    case LfoModulatableParameter::lfoStartingPhase_inverted:
+    case LfoModulatableParameter::lfoPhaseInterval_inverted:
+    case LfoModulatableParameter::lfoCurrentPhase_inverted:
+    case LfoModulatableParameter::lfoUpdateInterval_inverted:
+        return EvalOp::unipolarInverted;
+
+    case LfoModulatableParameter::pitch:
+    case LfoModulatableParameter::lfoRate:
+        return EvalOp::bipolarSemitones;
+
+    case LfoModulatableParameter::pitch_inverted:
+    case LfoModulatableParameter::lfoRate_inverted:
+        return EvalOp::bipolarSemitonesInverted;
+
+    default:
+        throw std::exception("Unknown or unimplemented modulation parameter");
+    }
+}
+bool ModulationMatrix::isLfoParameter(LfoModulatableParameter modulatedParameterID)
+{
+    switch (modulatedParameterID)
+    {
+    case LfoModulatableParameter::lfoRate:
+    case LfoModulatableParameter::lfoRate_inverted:
+    case LfoModulatableParameter::lfoStartingPhase:
+    case LfoModulatableParameter::lfoStartingPhase_inverted:
+    case LfoModulatableParameter::lfoPhaseInterval:
+    case LfoModulatableParameter::lfoPhaseInterval_inverted:
+    case LfoModulatableParameter::lfoCurrentPhase:
+    case LfoModulatableParameter::lfoCurrentPhase_inverted:
+    case LfoModulatableParameter::lfoUpdateInterval:
+    case LfoModulatableParameter::lfoUpdateInterval_inverted:
+        return true;
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.h
+    Created: 17 Oct 2026 1:21:44pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RegionLfo.h"
+#include "ModulatableParameter.h"
+#include "LfoModulatableParameter.h"
+
+/// <summary>
+/// Compiled form of all modulations between LFOs and modulatable parameters, as set up through RegionLfo::addRegionModulation.
+/// The LFOs (sources) are sorted topologically and assigned to levels: an LFO that is modulated by another LFO lies at least one level above it.
+/// Feedback cycles (e.g. an LFO modulating its own phase) are broken deterministically by ordering the LFOs within a cycle by their region ID;
+/// links that don't point to a higher level are feedback links.
+/// All links are stored in flat arrays (structure of arrays), grouped by their targets: first the voices' parameters, then the LFOs' parameters level by level.
+/// Every control step, the AudioEngine advances the LFOs level by level and calls processLfoLevel before each level, so that an LFO is modulated by
+/// the values that the LFOs below it have reached during the same step. Feedback links read the value that their source had at the end of the previous step.
+/// process() then applies the modulations of the voices' parameters before the voices are rendered.
+/// Only targets whose modulators have updated since they were last evaluated are set. All loops over links and targets are branch-free
+/// (every link is evaluated as offset + depth * (depthOffset + unipolarScale * unipolar + bipolarScale * bipolar),
+/// and every parameter as described in ModulatableParameter::evaluate), so that the compiler can vectorise them.
+/// </summary>
+class ModulationMatrix
+{
+public:
+    enum class EvalOp : int
+    {
+        unipolar = 0, //[1.0-depth, 1.0]
+        unipolarInverted, //[1.0, 1.0-depth]
+        bipolarSemitones, //[-12*depth, 12*depth]
+        bipolarSemitonesInverted //[12*depth, -12*depth]
+    };
+
+    ModulationMatrix(const juce::OwnedArray<RegionLfo>& lfos, int version);
+    ~ModulationMatrix();
+
+    void process(); //modulates the voices' parameters
+
+    //LFOs, level by level (audio thread)
+    int getNumLevels();
+    int getLevelStart(int level); //index of the first source of the level. getLevelStart(getNumLevels()) == number of sources
+    RegionLfo* getSource(int index);
+    void processLfoLevel(int level); //modulates the parameters of the LFOs of the given level. must be called before these LFOs are advanced
+
+    int getVersion();
+    int getNumLinks();
+    int getNumFeedbackLinks();
+
+    static EvalOp getEvalOp(LfoModulatableParameter modulatedParameterID);
+    static bool isLfoParameter(LfoModulatableParameter modulatedParameterID);
+
+private:
+    int version;
+
+    //sources (one per LFO, sorted by level, and topologically within each level)
+    juce::Array<RegionLfo*> sourceLfos;
+    juce::Array<int> levelStarts; //one per level, plus the end of the last level
+    juce::Array<juce::uint32> sourceUpdateCount; //incremented whenever the LFO is found to have updated
+    juce::uint32 totalUpdateCount = 0;
+    juce::Array<double> sourceUnipolar;
+    juce::Array<double> sourceBipolar;
+    juce::Array<double> sourceDepth;
+
+    //target groups: group 0 contains the voices' parameters, group 1 + n the parameters of the LFOs of level n.
+    //the targets and links of each group are contiguous
+    juce::Array<int> groupTargetStarts; //one per group, plus the end of the last group
+    juce::Array<int> groupLinkStarts;
+    juce::Array<juce::uint32> groupSeenUpdateCount; //totalUpdateCount when the group was last evaluated
+
+    //targets (one per modulated parameter)
+    juce::Array<ModulatableParameter<double>*> targetParameters;
+    juce::Array<double> targetMultiplicativeWeight; //1.0 for multiplicative, 0.0 for additive parameters
+    juce::Array<double> targetLowerCap;
+    juce::Array<bool> targetDirty;
+    juce::Array<double> targetCombinedModulation;
+    juce::Array<double> targetBaseValue;
+    juce::Array<double> targetModulatedValue;
+
+    //links
+    juce::Array<int> linkSources;
+    juce::Array<int> linkTargets;
+    juce::Array<EvalOp> linkOps;
+    juce::Array<juce::uint32> linkSeenUpdateCount; //sourceUpdateCount of the link's source when the link was last evaluated
+    int numFeedbackLinks = 0;
+
+    //coefficients of the links' evaluation functions (determined by their EvalOp)
+    juce::Array<double> linkOffset;
+    juce::Array<double> linkDepthOffset;
+    juce::Array<double> linkUnipolarScale;
+    juce::Array<double> linkBipolarScale;
+    juce::Array<double> linkValue;
+
+    void addLinkCoefficients(EvalOp op);
+    void gatherSources();
+    void evaluateGroup(int group);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
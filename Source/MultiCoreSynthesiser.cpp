@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    MultiCoreSynthesiser.cpp
+    Created: 17 Oct 2026 11:48:09am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "MultiCoreSynthesiser.h"
+
+MultiCoreSynthesiser::MultiCoreSynthesiser() :
+    juce::Synthesiser()
+{ }
+MultiCoreSynthesiser::~MultiCoreSynthesiser()
+{
+    DBG("destroying MultiCoreSynthesiser...");
+    setNumWorkers(0); //stops all workers before the voices are deleted
+    DBG("MultiCoreSynthesiser destroyed.");
+}
+
+void MultiCoreSynthesiser::prepareRenderBuffers(int numChannels, int maximumBlockSize)
+{
+    const juce::ScopedLock sl(lock); //the buffers mustn't be resized while rendering
+
+    renderBufferNumChannels = juce::jmax(1, numChannels);
+    renderBufferNumSamples = juce::jmax(1, maximumBlockSize);
+
+    for (auto* worker : workers)
+    {
+        worker->renderBuffer.setSize(renderBufferNumChannels, renderBufferNumSamples, false, true, true);
+    }
+}
+
+void MultiCoreSynthesiser::setNumWorkers(int newNumWorkers)
+{
+    newNumWorkers = juce::jmax(0, newNumWorkers);
+
+    //prepare the new workers before swapping them in, so that the audio thread only has to wait for the swap itself.
+    //they belong to the next epoch, so they can't claim any jobs before the swap. likewise, the old workers can't claim any jobs after it
+    //(even if they have already seen jobs of a previous sub-block and are just about to claim one).
+    int newEpoch = workerEpoch + 1; //only ever changed on this thread
+    juce::OwnedArray<Worker> replacedWorkers;
+    for (int i = 0; i < newNumWorkers; ++i)
+    {
+        auto* newWorker = replacedWorkers.add(new Worker(*this, newEpoch, renderBufferNumChannels, renderBufferNumSamples));
+        newWorker->startThread();
+    }
+
+    {
+        const juce::ScopedLock sl(lock); //not rendering -> all jobs of the old epoch have been rendered
+        workers.swapWith(replacedWorkers);
+        workerEpoch = newEpoch;
+    }
+
+    //replacedWorkers now contains the old workers -> stop them
+    for (auto* oldWorker : replacedWorkers)
+    {
+        oldWorker->signalThreadShouldExit();
+        oldWorker->wakeUpEvent.signal();
+    }
+    for (auto* oldWorker : replacedWorkers)
+    {
+        oldWorker->stopThread(1000);
+    }
+    replacedWorkers.clear(true);
+
+    DBG("number of render workers: " + juce::String(newNumWorkers));
+}
+juce::SynthesiserVoice* MultiCoreSynthesiser::releaseVoice(int index)
+{
+    const juce::ScopedLock sl(lock);
+    return voices.removeAndReturn(index);
+}
+
+int MultiCoreSynthesiser::getNumWorkers()
+{
+    return workers.size();
+}
+
+void MultiCoreSynthesiser::invalidateVoiceGroups()
+{
+    voiceGroupsVersion.fetch_add(1);
+}
+int MultiCoreSynthesiser::getVoiceGroupsVersion()
+{
+    return voiceGroupsVersion.load();
+}
+void MultiCoreSynthesiser::setVoiceGroups(const juce::Array<juce::Array<int>>& newVoiceGroups, int version)
+{
+    auto newGraph = std::make_unique<VoiceGroupGraph>();
+    newGraph->version = version;
+    newGraph->numVoices = voices.size();
+
+    //start with the largest groups, so that the smaller ones can fill the gaps at the end of each sub-block
+    juce::Array<juce::Array<int>> sortedGroups(newVoiceGroups);
+    std::sort(sortedGroups.begin(), sortedGroups.end(), [](const juce::Array<int>& a, const juce::Array<int>& b) { return a.size() > b.size(); });
+
+    for (auto& group : sortedGroups)
+    {
+        if (group.size() == 0)
+        {
+            continue;
+        }
+
+        newGraph->groupStarts.add(newGraph->voices.size());
+        for (int voiceIndex : group)
+        {
+            newGraph->voices.add(voices[voiceIndex]);
+        }
+    }
+    newGraph->numGroups = newGraph->groupStarts.size();
+    newGraph->groupStarts.add(newGraph->voices.size()); //end of the last group
+    jassert(newGraph->voices.size() == newGraph->numVoices); //otherwise, some voices wouldn't be rendered
+
+    {
+        const juce::ScopedLock sl(lock); //the graph is only ever accessed while rendering, i.e. while holding this lock
+        std::swap(voiceGroupGraph, newGraph);
+    }
+    //newGraph now contains the old graph, which is deleted here (outside of the lock)
+}
+
+bool MultiCoreSynthesiser::canRenderInParallel(juce::AudioBuffer<float>& outputAudio, int numSamples)
+{
+    return workers.size() > 0
+        && voiceGroupGraph != nullptr
+        && voiceGroupGraph->version == voiceGroupsVersion.load()
+        && voiceGroupGraph->numVoices == voices.size()
+        && voiceGroupGraph->numGroups > 1 //with only one group, there's nothing to parallelise
+        && numSamples <= renderBufferNumSamples
+        && outputAudio.getNumChannels() <= renderBufferNumChannels;
+}
+
+void MultiCoreSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    //note: the synth's lock is being held here
+
+    if (!canRenderInParallel(outputAudio, numSamples))
+    {
+        juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples); //serial rendering
+        return;
+    }
+
+    //publish the jobs of this sub-block. jobsToClaim must be set last, since that is what the workers are waiting for.
+    int generation = jobGeneration.load(std::memory_order_relaxed) + 1;
+    jobGeneration.store(generation, std::memory_order_relaxed);
+    jobNumSamples.store(numSamples, std::memory_order_relaxed);
+    jobsRemaining.store(voiceGroupGraph->numGroups, std::memory_order_relaxed);
+    jobsToClaim.store(packJobs(workerEpoch, voiceGroupGraph->numGroups)); //sequentially consistent (pairs with the workers' isSleeping flag)
+
+    for (auto* worker : workers)
+    {
+        if (worker->isSleeping.load())
+        {
+            worker->wakeUpEvent.signal(); //doesn't block
+        }
+    }
+
+    //the audio thread works on the jobs as well, rendering directly into the output buffer
+    for (int job = claimJob(workerEpoch); job >= 0; job = claimJob(workerEpoch))
+    {
+        renderGroup(job, outputAudio, startSample, numSamples);
+        jobsRemaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    //all jobs have been claimed -> wait for the workers to finish theirs. no locks or events are involved, and since no new jobs can be claimed anymore,
+    //the wait is bounded by the time it takes to render one group. spin briefly first (cheapest if the workers are about to finish), then yield so that a preempted worker can get the core back
+    for (int spins = 0; jobsRemaining.load(std::memory_order_acquire) > 0; ++spins)
+    {
+        if (spins >= maxWaitSpins)
+        {
+            juce::Thread::yield();
+        }
+    }
+
+    //sum up the workers' buffers
+    for (auto* worker : workers)
+    {
+        if (worker->usedInGeneration.load(std::memory_order_relaxed) == generation)
+        {
+            for (int ch = 0; ch < outputAudio.getNumChannels(); ++ch)
+            {
+                outputAudio.addFrom(ch, startSample, worker->renderBuffer, ch, 0, numSamples);
+            }
+        }
+    }
+}
+
+juce::int64 MultiCoreSynthesiser::packJobs(int epoch, int numJobs)
+{
+    return (static_cast<juce::int64>(epoch) << 32) | static_cast<juce::int64>(static_cast<juce::uint32>(numJobs));
+}
+bool MultiCoreSynthesiser::hasJobsToClaim(int epoch)
+{
+    juce::int64 state = jobsToClaim.load(std::memory_order_acquire);
+    return static_cast<int>(state >> 32) == epoch && static_cast<int>(state & 0xffffffff) > 0;
+}
+int MultiCoreSynthesiser::claimJob(int epoch)
+{
+    juce::int64 state = jobsToClaim.load(std::memory_order_acquire);
+
+    while (static_cast<int>(state >> 32) == epoch)
+    {
+        int numJobs = static_cast<int>(state & 0xffffffff);
+        if (numJobs <= 0)
+        {
+            break;
+        }
+        if (jobsToClaim.compare_exchange_weak(state, packJobs(epoch, numJobs - 1), std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return numJobs - 1;
+        }
+        //state has been reloaded -> try again
+    }
+
+    return -1;
+}
+
+void MultiCoreSynthesiser::workOnJobs(Worker* worker)
+{
+    for (int job = claimJob(worker->epoch); job >= 0; job = claimJob(worker->epoch))
+    {
+        //a job has been claimed -> the parameters of its sub-block are visible and won't change until jobsRemaining reaches 0
+        int generation = jobGeneration.load(std::memory_order_relaxed);
+        int numSamples = jobNumSamples.load(std::memory_order_relaxed);
+
+        if (worker->usedInGeneration.load(std::memory_order_relaxed) != generation)
+        {
+            //first job of this worker during the current sub-block
+            worker->renderBuffer.clear(0, numSamples);
+            worker->usedInGeneration.store(generation, std::memory_order_relaxed);
+        }
+
+        renderGroup(job, worker->renderBuffer, 0, numSamples);
+        jobsRemaining.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void MultiCoreSynthesiser::renderGroup(int groupIndex, juce::AudioBuffer<float>& target, int startSample, int numSamples)
+{
+    auto* graph = voiceGroupGraph.get();
+    int groupEnd = graph->groupStarts.getUnchecked(groupIndex + 1);
+
+    for (int i = graph->groupStarts.getUnchecked(groupIndex); i < groupEnd; ++i)
+    {
+        graph->voices.getUnchecked(i)->renderNextBlock(target, startSample, numSamples);
+    }
+}
+
+
+
+
+MultiCoreSynthesiser::Worker::Worker(MultiCoreSynthesiser& owner, int epoch, int numChannels, int numSamples) :
+    juce::Thread("Voice render worker"),
+    epoch(epoch),
+    owner(owner)
+{
+    renderBuffer.setSize(numChannels, numSamples);
+}
+MultiCoreSynthesiser::Worker::~Worker()
+{
+    signalThreadShouldExit();
+    wakeUpEvent.signal();
+    stopThread(1000);
+}
+
+void MultiCoreSynthesiser::Worker::run()
+{
+    int idleSpins = 0;
+
+    while (!threadShouldExit())
+    {
+        if (owner.hasJobsToClaim(epoch))
+        {
+            owner.workOnJobs(this);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (++idleSpins < maxIdleSpins)
+        {
+            juce::Thread::yield();
+            continue;
+        }
+
+        //no jobs for a while (e.g. the host has stopped playback or there's only one voice group) -> sleep until the audio thread wakes this worker up
+        isSleeping.store(true);
+        if (!owner.hasJobsToClaim(epoch)) //checked again after setting isSleeping, so that no wake-up can be missed
+        {
+            wakeUpEvent.wait(10);
+        }
+        isSleeping.store(false);
+        idleSpins = 0;
+    }
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    MultiCoreSynthesiser.h
+    Created: 17 Oct 2026 11:48:09am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/// <summary>
+/// Synthesiser that can render independent groups of voices in parallel on a pool of worker threads.
+/// Voices are independent if they don't write to anything that other voices read while rendering. The groups are determined by the AudioEngine (one group per region).
+/// Scheduling is lock-free: each sub-block, the audio thread publishes the jobs (one per group) via atomics, and all threads (including the audio thread itself)
+/// claim jobs until none are left. Jobs are tagged with the epoch of the current set of workers, so that workers which have already been replaced can't claim any. Every worker renders into its own buffer, and the audio thread sums those buffers up at the end.
+/// If there are no workers or the groups are outdated, the voices are rendered serially just like in juce::Synthesiser.
+/// </summary>
+class MultiCoreSynthesiser : public juce::Synthesiser
+{
+public:
+    MultiCoreSynthesiser();
+    ~MultiCoreSynthesiser() override;
+
+    void prepareRenderBuffers(int numChannels, int maximumBlockSize);
+
+    juce::SynthesiserVoice* releaseVoice(int index); //removes the voice without deleting it, so that it can be deleted outside of the synth's lock. the caller takes ownership
+
+    void setNumWorkers(int newNumWorkers);
+    int getNumWorkers();
+
+    /// <summary>
+    /// Marks the current voice groups as outdated, so that the voices are rendered serially until setVoiceGroups is called with the new version.
+    /// Must be called *before* voices are added, removed or moved to another region.
+    /// </summary>
+    void invalidateVoiceGroups();
+    int getVoiceGroupsVersion();
+    /// <summary>
+    /// Sets the groups of voices that can be rendered independently of one another.
+    /// </summary>
+    /// <param name="newVoiceGroups">One array of voice indices per group. Every voice must be contained in exactly one group.</param>
+    /// <param name="version">The value that getVoiceGroupsVersion returned before the groups were determined.</param>
+    void setVoiceGroups(const juce::Array<juce::Array<int>>& newVoiceGroups, int version);
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+    /// <summary>
+    /// Flat list of all voices, sorted by group. groupStarts[g] is the index of the first voice of group g; groupStarts[numGroups] == voices.size().
+    /// </summary>
+    struct VoiceGroupGraph
+    {
+        juce::Array<juce::SynthesiserVoice*> voices;
+        juce::Array<int> groupStarts;
+        int numGroups = 0;
+        int numVoices = 0; //total number of voices of the synth when the graph was built
+        int version = -1;
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(MultiCoreSynthesiser& owner, int epoch, int numChannels, int numSamples);
+        ~Worker() override;
+
+        void run() override;
+
+        juce::AudioBuffer<float> renderBuffer;
+        std::atomic<int> usedInGeneration { -1 }; //generation of the jobs that have last been rendered into renderBuffer
+        std::atomic<bool> isSleeping { false };
+        juce::WaitableEvent wakeUpEvent;
+        const int epoch; //the worker may only claim jobs that have been published for this epoch
+
+    private:
+        MultiCoreSynthesiser& owner;
+
+        static const int maxIdleSpins = 64; //number of yields before the worker goes to sleep. keeps the worker awake between sub-blocks that follow one another closely, without keeping a core busy while idle
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+    };
+
+    static const int maxWaitSpins = 256; //number of busy iterations before the audio thread starts yielding while it waits for the workers
+
+    bool canRenderInParallel(juce::AudioBuffer<float>& outputAudio, int numSamples);
+    static juce::int64 packJobs(int epoch, int numJobs);
+    bool hasJobsToClaim(int epoch);
+    int claimJob(int epoch); //returns the index of the claimed job, or -1 if there are no (more) jobs for this epoch
+    void workOnJobs(Worker* worker);
+    void renderGroup(int groupIndex, juce::AudioBuffer<float>& target, int startSample, int numSamples);
+
+    juce::OwnedArray<Worker> workers;
+    int workerEpoch = 0; //incremented whenever the workers are replaced (while holding the synth's lock)
+    int renderBufferNumChannels = 2;
+    int renderBufferNumSamples = 512;
+
+    std::unique_ptr<VoiceGroupGraph> voiceGroupGraph; //only replaced while holding the synth's lock, i.e. never while rendering
+    std::atomic<int> voiceGroupsVersion { 0 };
+
+    //jobs of the current sub-block (written by the audio thread before the jobs are published)
+    std::atomic<int> jobGeneration { 0 };
+    std::atomic<int> jobNumSamples { 0 };
+    std::atomic<juce::int64> jobsToClaim { 0 }; //epoch (upper 32 bits) and number of unclaimed jobs (lower 32 bits). claiming the job with index (number - 1) counts down via compare-and-swap
+    std::atomic<int> jobsRemaining { 0 }; //counts down once a job has been rendered
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiCoreSynthesiser)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    OutlineWaveTableBuilder.cpp
+    Created: 17 Oct 2026 9:37:52pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "OutlineWaveTableBuilder.h"
+
+//constants
+const int OutlineWaveTableBuilder::minTableLength = 16;
+const int OutlineWaveTableBuilder::maxTableLength = 4096;
+const float OutlineWaveTableBuilder::defaultErrorTolerance = 0.002f;
+
+
+
+
+OutlineWaveTableBuilder::OutlineWaveTableBuilder()
+{ }
+
+void OutlineWaveTableBuilder::setErrorTolerance(float newErrorTolerance)
+{
+    errorTolerance = juce::jmax(0.0f, newErrorTolerance);
+}
+float OutlineWaveTableBuilder::getErrorTolerance()
+{
+    return errorTolerance;
+}
+void OutlineWaveTableBuilder::setUsePowerOfTwoSizes(bool shouldUsePowerOfTwoSizes)
+{
+    usePowerOfTwoSizes = shouldUsePowerOfTwoSizes;
+}
+bool OutlineWaveTableBuilder::getUsePowerOfTwoSizes()
+{
+    return usePowerOfTwoSizes;
+}
+void OutlineWaveTableBuilder::setMaxHarmonic(int newMaxHarmonic)
+{
+    maxHarmonic = juce::jmax(0, newMaxHarmonic);
+}
+int OutlineWaveTableBuilder::getMaxHarmonic()
+{
+    return maxHarmonic;
+}
+
+juce::Range<float> OutlineWaveTableBuilder::build(const PathArcLengthTable& outline, juce::Point<float> focus, juce::AudioBuffer<float>& waveTable) const
+{
+    juce::Array<float> values; //unique samples (without the wrap sample)
+    juce::Array<float> midpoints;
+    values.resize(minTableLength);
+    juce::Range<float> range = sample(outline, focus, minTableLength, 0.0f, values.getRawDataPointer());
+    float previousError = 0.0f;
+
+    //refine until the midpoints between all samples are approximated well enough by linear interpolation.
+    //the midpoints become the new samples when doubling the length, so no point of the outline is evaluated more than once
+    while (values.size() < maxTableLength)
+    {
+        const int numSamples = values.size();
+        midpoints.resize(numSamples);
+        range = range.getUnionWith(sample(outline, focus, numSamples, 0.5f, midpoints.getRawDataPointer()));
+
+        float error = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float interpolated = 0.5f * (values.getUnchecked(i) + values.getUnchecked((i + 1) % numSamples));
+            error = juce::jmax(error, std::abs(midpoints.getUnchecked(i) - interpolated));
+        }
+        error /= juce::jmax(range.getLength(), std::numeric_limits<float>::min()); //relative to the range of the values
+
+        if (error <= errorTolerance)
+        {
+            break; //detailed enough
+        }
+
+        values.resize(numSamples * 2);
+        for (int i = numSamples - 1; i >= 0; --i) //backwards, so that no sample is overwritten before it has been moved
+        {
+            values.setUnchecked(2 * i, values.getUnchecked(i));
+            values.setUnchecked(2 * i + 1, midpoints.getUnchecked(i));
+        }
+        previousError = error;
+    }
+
+    if (!usePowerOfTwoSizes && maxHarmonic == 0 && values.size() > minTableLength)
+    {
+        //the interpolation error decreases quadratically with the sample density. the previous length was too short, so the ideal length lies in between
+        const int previousLength = values.size() / 2;
+        int numSamples = static_cast<int>(std::ceil(static_cast<float>(previousLength) * std::sqrt(previousError / juce::jmax(errorTolerance, std::numeric_limits<float>::min()))));
+        numSamples = juce::jlimit(previousLength + 1, values.size(), numSamples);
+
+        if (numSamples < values.size())
+        {
+            values.resize(numSamples);
+            range = sample(outline, focus, numSamples, 0.0f, values.getRawDataPointer());
+        }
+    }
+
+    //range of the actual distances (used to calculate the LFO's depth)
+    juce::Range<float> distanceRange = range;
+
+    if (maxHarmonic > 0 && maxHarmonic < values.size() / 2)
+    {
+        bandLimit(values, maxHarmonic);
+        range = juce::FloatVectorOperations::findMinAndMax(values.getRawDataPointer(), values.size()); //band-limiting may cause ringing
+    }
+
+    //normalise to 0...1 (converted to -1...1 by RegionLfo if necessary)
+    waveTable.setSize(1, values.size() + 1);
+    auto samples = waveTable.getWritePointer(0);
+    float mult = (range.getLength() > 0.0f) ? 1.0f / range.getLength() : 0.0f; //a constant distance (e.g. a circle around the focus point) results in a flat table
+    for (int i = 0; i < values.size(); ++i)
+    {
+        samples[i] = (values.getUnchecked(i) - range.getStart()) * mult;
+    }
+    samples[values.size()] = samples[0]; //the last sample is equal to the first -> makes wrapping simpler and faster
+
+    return distanceRange;
+}
+
+juce::Range<float> OutlineWaveTableBuilder::sample(const PathArcLengthTable& outline, juce::Point<float> focus, int numSamples, float offset, float* destination)
+{
+    float stepDistance = outline.getLength() / static_cast<float>(numSamples);
+    int segment = 0; //the distances increase monotonically, so the search can continue where it left off (amortised O(1) per sample)
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        destination[i] = outline.getPointAlongPath((static_cast<float>(i) + offset) * stepDistance, segment)
+            .getDistanceSquaredFrom(focus); //use distance from focus point to create a 1D value
+    }
+
+    return juce::FloatVectorOperations::findMinAndMax(destination, numSamples);
+}
+
+void OutlineWaveTableBuilder::bandLimit(juce::Array<float>& values, int maxHarmonic)
+{
+    const int numSamples = values.size();
+    juce::dsp::FFT fft(juce::roundToInt(std::log2(static_cast<double>(numSamples))));
+
+    juce::HeapBlock<float> data(2 * numSamples, true); //the real-only transforms work in place and need twice the space
+    juce::FloatVectorOperations::copy(data.get(), values.getRawDataPointer(), numSamples);
+    fft.performRealOnlyForwardTransform(data.get());
+
+    //remove all harmonics above maxHarmonic (and their negative-frequency mirrors)
+    for (int bin = maxHarmonic + 1; bin < numSamples - maxHarmonic; ++bin)
+    {
+        data[2 * bin] = 0.0f;
+        data[2 * bin + 1] = 0.0f;
+    }
+
+    fft.performRealOnlyInverseTransform(data.get());
+    juce::FloatVectorOperations::copy(values.getRawDataPointer(), data.get(), numSamples);
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    OutlineWaveTableBuilder.h
+    Created: 17 Oct 2026 9:37:52pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PathArcLengthTable.h"
+
+/// <summary>
+/// Builds the wavetable of a region's LFO from its outline: the table describes the (squared) distance from the focus point while walking along the outline, normalised to [0,1].
+/// Instead of using one sample per pixel of the outline, the table length is chosen according to the outline's detail: starting at minTableLength, the table is refined
+/// (by doubling its length) until the linearly interpolated table deviates from the outline's distance curve by no more than the error tolerance.
+/// Smooth outlines thus result in short tables, no matter how large they are, while detailed outlines get as many samples as their detail requires (up to maxTableLength).
+/// By default, the number of unique samples is a power of two. Optionally, the table can be band-limited, so that the LFO doesn't alias when it's run at audio rates.
+/// Must only be used on the message thread.
+/// </summary>
+class OutlineWaveTableBuilder
+{
+public:
+    OutlineWaveTableBuilder();
+
+    void setErrorTolerance(float newErrorTolerance); //maximum deviation, relative to the range of the table's values
+    float getErrorTolerance();
+    void setUsePowerOfTwoSizes(bool shouldUsePowerOfTwoSizes);
+    bool getUsePowerOfTwoSizes();
+    void setMaxHarmonic(int newMaxHarmonic); //highest harmonic that the table may contain. 0 disables band-limiting. band-limited tables always have power-of-two sizes
+    int getMaxHarmonic();
+
+    /// <summary>
+    /// Builds the wavetable. Like all LFO wavetables, its last sample equals its first one.
+    /// </summary>
+    /// <param name="outline">The outline to walk along</param>
+    /// <param name="focus">The point whose distance is measured (in the outline's coordinates)</param>
+    /// <param name="waveTable">Receives the unipolar wavetable (one channel)</param>
+    /// <returns>The range of the squared distances before normalisation</returns>
+    juce::Range<float> build(const PathArcLengthTable& outline, juce::Point<float> focus, juce::AudioBuffer<float>& waveTable) const;
+
+    static const int minTableLength; //number of unique samples (power of two)
+    static const int maxTableLength; //number of unique samples (power of two)
+    static const float defaultErrorTolerance;
+
+private:
+    float errorTolerance = defaultErrorTolerance;
+    bool usePowerOfTwoSizes = true;
+    int maxHarmonic = 0;
+
+    //samples numSamples equidistant points of the outline, starting at offset * (length / numSamples). returns the range of the sampled values
+    static juce::Range<float> sample(const PathArcLengthTable& outline, juce::Point<float> focus, int numSamples, float offset, float* destination);
+    static void bandLimit(juce::Array<float>& values, int maxHarmonic); //values.size() must be a power of two
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutlineWaveTableBuilder)
+};
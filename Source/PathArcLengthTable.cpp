@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    PathArcLengthTable.cpp
+    Created: 17 Oct 2026 9:12:26pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "PathArcLengthTable.h"
+
+PathArcLengthTable::PathArcLengthTable()
+{ }
+
+void PathArcLengthTable::rebuild(const juce::Path& path)
+{
+    points.clearQuick();
+    distances.clearQuick();
+
+    float length = 0.0f;
+    juce::PathFlatteningIterator it(path, juce::AffineTransform(), juce::Path::defaultToleranceForMeasurement);
+
+    while (it.next())
+    {
+        juce::Point<float> start(it.x1, it.y1);
+        juce::Point<float> end(it.x2, it.y2);
+
+        if (points.isEmpty() || points.getLast() != start)
+        {
+            //first segment of a (sub-)path. jumps between sub-paths don't add any length, just like in juce::Path::getLength
+            points.add(start);
+            distances.add(length);
+        }
+
+        length += start.getDistanceFrom(end);
+        points.add(end);
+        distances.add(length);
+    }
+
+    bounds = juce::Rectangle<float>::findAreaContainingPoints(points.begin(), points.size());
+}
+
+float PathArcLengthTable::getLength() const
+{
+    return distances.isEmpty() ? 0.0f : distances.getLast();
+}
+
+juce::Point<float> PathArcLengthTable::getPointAlongPath(float distanceFromStart) const
+{
+    if (points.size() < 2)
+    {
+        return points.isEmpty() ? juce::Point<float>() : points.getFirst();
+    }
+
+    //find the last point that doesn't lie beyond the given distance
+    const float* firstDistance = distances.begin();
+    int segment = static_cast<int>(std::upper_bound(firstDistance, distances.end(), distanceFromStart) - firstDistance) - 1;
+    return interpolate(juce::jlimit(0, points.size() - 2, segment), distanceFromStart);
+}
+juce::Point<float> PathArcLengthTable::getPointAlongPath(float distanceFromStart, int& segmentHint) const
+{
+    if (points.size() < 2)
+    {
+        return points.isEmpty() ? juce::Point<float>() : points.getFirst();
+    }
+
+    int lastSegment = points.size() - 2;
+    segmentHint = juce::jlimit(0, lastSegment, segmentHint);
+
+    if (distanceFromStart < distances.getUnchecked(segmentHint))
+    {
+        //went backwards (e.g. wrapped around) -> search from scratch
+        const float* firstDistance = distances.begin();
+        segmentHint = juce::jlimit(0, lastSegment, static_cast<int>(std::upper_bound(firstDistance, distances.end(), distanceFromStart) - firstDistance) - 1);
+    }
+    else
+    {
+        while (segmentHint < lastSegment && distances.getUnchecked(segmentHint + 1) <= distanceFromStart)
+        {
+            ++segmentHint;
+        }
+    }
+
+    return interpolate(segmentHint, distanceFromStart);
+}
+
+void PathArcLengthTable::findIntersections(const juce::Path& outline, const juce::AffineTransform& outlineTransform, juce::Array<float>& intersectionDistances) const
+{
+    intersectionDistances.clearQuick();
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    juce::Array<juce::Line<float>> edges;
+    collectClosedEdges(outline, outlineTransform, edges);
+
+    //intersect every edge with every segment of this path. bounding boxes are compared first, so that most pairs are rejected early
+    for (auto& edge : edges)
+    {
+        juce::Rectangle<float> edgeBounds(edge.getStart(), edge.getEnd());
+        if (edgeBounds.getRight() < bounds.getX() || edgeBounds.getX() > bounds.getRight()
+            || edgeBounds.getBottom() < bounds.getY() || edgeBounds.getY() > bounds.getBottom()) //(not Rectangle::intersects, which is always false for horizontal or vertical edges)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < points.size() - 1; ++i)
+        {
+            if (distances.getUnchecked(i + 1) <= distances.getUnchecked(i))
+            {
+                continue; //jump between sub-paths (doesn't belong to the path)
+            }
+
+            auto segmentStart = points.getUnchecked(i);
+            auto segmentEnd = points.getUnchecked(i + 1);
+            if (juce::jmax(segmentStart.x, segmentEnd.x) < edgeBounds.getX() || juce::jmin(segmentStart.x, segmentEnd.x) > edgeBounds.getRight()
+                || juce::jmax(segmentStart.y, segmentEnd.y) < edgeBounds.getY() || juce::jmin(segmentStart.y, segmentEnd.y) > edgeBounds.getBottom())
+            {
+                continue;
+            }
+
+            juce::Point<float> intersection;
+            if (juce::Line<float>(segmentStart, segmentEnd).intersects(edge, intersection))
+            {
+                intersectionDistances.add(juce::jmin(distances.getUnchecked(i + 1), distances.getUnchecked(i) + segmentStart.getDistanceFrom(intersection)));
+            }
+        }
+    }
+
+    std::sort(intersectionDistances.begin(), intersectionDistances.end());
+}
+void PathArcLengthTable::collectClosedEdges(const juce::Path& path, const juce::AffineTransform& transform, juce::Array<juce::Line<float>>& edges)
+{
+    edges.clearQuick();
+    juce::PathFlatteningIterator it(path, transform, juce::Path::defaultToleranceForTesting);
+    juce::Point<float> subPathStart, lastEnd;
+    bool hasSubPath = false;
+
+    while (it.next())
+    {
+        juce::Point<float> start(it.x1, it.y1);
+        juce::Point<float> end(it.x2, it.y2);
+
+        if (!hasSubPath || start != lastEnd)
+        {
+            if (hasSubPath && lastEnd != subPathStart)
+            {
+                edges.add(juce::Line<float>(lastEnd, subPathStart));
+            }
+            subPathStart = start;
+            hasSubPath = true;
+        }
+
+        edges.add(juce::Line<float>(start, end));
+        lastEnd = end;
+    }
+    if (hasSubPath && lastEnd != subPathStart)
+    {
+        edges.add(juce::Line<float>(lastEnd, subPathStart));
+    }
+}
+
+juce::Point<float> PathArcLengthTable::interpolate(int segment, float distanceFromStart) const
+{
+    float segmentStart = distances.getUnchecked(segment);
+    float segmentLength = distances.getUnchecked(segment + 1) - segmentStart;
+    float ratio = (segmentLength > 0.0f) ? juce::jlimit(0.0f, 1.0f, (distanceFromStart - segmentStart) / segmentLength) : 0.0f;
+
+    auto start = points.getUnchecked(segment);
+    return start + (points.getUnchecked(segment + 1) - start) * ratio;
+}
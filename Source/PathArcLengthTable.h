@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    PathArcLengthTable.h
+    Created: 17 Oct 2026 9:12:26pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/// <summary>
+/// Flattened version of a path with the distance from the start at every vertex.
+/// juce::Path::getPointAlongPath walks the path from its start on every call. This table is built once per outline (O(n))
+/// and then finds points along the path via binary search (O(log n)), or in amortised constant time for sweeps with increasing distances.
+/// The distances match juce::Path::getLength and juce::Path::getPointAlongPath (default measurement tolerance).
+/// </summary>
+class PathArcLengthTable
+{
+public:
+    PathArcLengthTable();
+
+    void rebuild(const juce::Path& path); //must be called whenever the path changes
+
+    float getLength() const;
+
+    juce::Point<float> getPointAlongPath(float distanceFromStart) const;
+    /// <summary>
+    /// Same as above, but continues searching from the segment of the previous call. Use this when sweeping along the path.
+    /// </summary>
+    /// <param name="segmentHint">Index of the segment that the previous point was found in. Should be 0 before the first call. Updated by the call.</param>
+    juce::Point<float> getPointAlongPath(float distanceFromStart, int& segmentHint) const;
+
+    /// <summary>
+    /// Finds all points at which the given outline crosses this path (exact intersections of the segments of both flattened paths). Sub-paths of the outline are treated as closed.
+    /// </summary>
+    /// <param name="outlineTransform">Transforms the outline into the coordinates of this path</param>
+    /// <param name="intersectionDistances">Receives the distances from the start of this path at which the intersections lie, in ascending order</param>
+    void findIntersections(const juce::Path& outline, const juce::AffineTransform& outlineTransform, juce::Array<float>& intersectionDistances) const;
+
+    /// <summary>
+    /// Collects the edges of the flattened path. Open sub-paths are closed, just like in juce::Path::contains. Shared by findIntersections and RegionMask.
+    /// </summary>
+    static void collectClosedEdges(const juce::Path& path, const juce::AffineTransform& transform, juce::Array<juce::Line<float>>& edges);
+
+private:
+    juce::Array<juce::Point<float>> points;
+    juce::Array<float> distances; //distance from the start of the path at each point (non-decreasing)
+    juce::Rectangle<float> bounds; //bounds of all points
+
+    juce::Point<float> interpolate(int segment, float distanceFromStart) const; //segment i lies between points i and i + 1
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PathArcLengthTable)
+};
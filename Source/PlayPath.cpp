@@ -26,6 +26,7 @@ PlayPath::PlayPath(int ID, const juce::Path& path, const juce::Rectangle<float>&
     fillColour(fillColour)
 {
     this->ID = ID;
+    pathTable.rebuild(underlyingPath);
 
     //initialiseStates
     states[static_cast<int>(PlayPathStateIndex::notInteractable)] = static_cast<PlayPathState*>(new PlayPathState_NotInteractable(*this));
@@ -55,6 +56,8 @@ PlayPath::PlayPath(int ID, const juce::Path& path, const juce::Rectangle<float>&
 }
 PlayPath::~PlayPath()
 {
+    cancelPendingUpdate();
+
     if (pathEditorWindow != nullptr) //is editor currently opened?
     {
         pathEditorWindow.deleteAndZero(); //close and release
@@ -242,8 +245,10 @@ void PlayPath::resized()
 
     //recalculate hitbox
     underlyingPath.scaleToFit(0.0f, 0.0f, (float)getWidth(), (float)getHeight(), false);
+    pathTable.rebuild(underlyingPath);
 
     //adjust any courier(s)
+    const juce::SpinLock::ScopedLockType lock(courierLock); //the audio thread mustn't move the couriers while their radius changes
     for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
     {
         (*itCourier)->parentPathLengthChanged(); //needed to adjust the ratio of the courier's radius to the window size
@@ -287,11 +292,11 @@ juce::String PlayPath::getTooltip()
 
 juce::Point<float> PlayPath::getPointAlongPath(double normedDistanceFromStart)
 {
-    return underlyingPath.getPointAlongPath(normedDistanceFromStart * underlyingPath.getLength());
+    return pathTable.getPointAlongPath(static_cast<float>(normedDistanceFromStart) * pathTable.getLength());
 }
 float PlayPath::getPathLength()
 {
-    return underlyingPath.getLength();
+    return pathTable.getLength();
 }
 
 void PlayPath::clicked(const juce::ModifierKeys& modifiers)
@@ -345,36 +350,26 @@ bool PlayPath::shouldBePlaying()
 }
 void PlayPath::startPlaying(bool toggleButtonState)
 {
+    JUCE_ASSERT_MESSAGE_THREAD //MIDI messages are passed on via handleAsyncUpdate
+
     if (!isPlaying && shouldBePlaying())
     {
         //play couriers (have been prepared in advance)
         DBG("playing path " + juce::String(ID));
         isPlaying = true;
 
-        //try to set the button's toggle state to "down" (needs to be done cross-thread for MIDI messages because they do not run on the same thread as couriers and clicks)
         if (toggleButtonState)
         {
-            if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-            {
-                setToggleState(true, juce::NotificationType::dontSendNotification);
-                //setState(juce::Button::ButtonState::buttonDown);
-            }
-            else
-            {
-                juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                    {
-                        static_cast<PlayPath*>(data)->setToggleState(true, juce::NotificationType::dontSendNotification);
-                        return static_cast<void*>(nullptr);
-                    }, this);
-            }
+            setToggleState(true, juce::NotificationType::dontSendNotification);
+            //setState(juce::Button::ButtonState::buttonDown);
         }
 
+        //courierLock isn't needed here: only the message thread changes the couriers array, and the audio thread ignores couriers that aren't running.
+        //the couriers only start running once all regions that they start in have been signalled.
         for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
         {
-            (*itCourier)->startRunning();
-
             //check whether the courier is already within a region when it's at its starting point
-            juce::Range<float> currentRange = (*itCourier)->getCurrentRange();
+            juce::Range<float> currentRange = (*itCourier)->getCurrentRange(); //stopped couriers are always at the start
             auto itRegion = regionsByRange_region.begin();
             auto itRange = regionsByRange_range.begin();
             for (; itRange != regionsByRange_range.end(); ++itRegion, ++itRange)
@@ -383,37 +378,41 @@ void PlayPath::startPlaying(bool toggleButtonState)
                 {
                     //if any courier starts out within a region, immediately start playing that region
                     (*itRegion)->signalCourierEntered();
+                    (*itCourier)->signalRegionEntered((*itRegion)->getID()); //so that the region is signalled when the courier leaves it or is stopped
                 }
             }
+
+            (*itCourier)->startRunning();
         }
     }
 }
 void PlayPath::stopPlaying(bool toggleButtonState)
 {
+    JUCE_ASSERT_MESSAGE_THREAD //MIDI messages are passed on via handleAsyncUpdate
+
     if (isPlaying && !shouldBePlaying())
     {
         //stop and delete all current couriers
         DBG("stopping path " + juce::String(ID));
 
-        //try to set the button's toggle state to "up" (needs to be done cross-thread for MIDI messages because they do not run on the same thread as couriers and clicks)
         if (toggleButtonState)
         {
-            if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-            {
-                setToggleState(false, juce::NotificationType::dontSendNotification);
-                //setState(juce::Button::ButtonState::buttonDown);
-            }
-            else
-            {
-                juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                    {
-                        static_cast<PlayPath*>(data)->setToggleState(false, juce::NotificationType::dontSendNotification);
-                        return static_cast<void*>(nullptr);
-                    }, this);
-            }
+            setToggleState(false, juce::NotificationType::dontSendNotification);
+            //setState(juce::Button::ButtonState::buttonDown);
         }
 
-        for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
+        //prepare one new courier for the next time that this path is played
+        juce::OwnedArray<PlayPathCourier> replacedCouriers;
+        PlayPathCourier* newCourier = replacedCouriers.add(new PlayPathCourier(this, courierIntervalSeconds));
+        newCourier->reserveIntersectedRegions(regionsByRange_region.size());
+
+        {
+            const juce::SpinLock::ScopedLockType lock(courierLock); //the audio thread mustn't move the couriers while they're being replaced
+            couriers.swapWith(replacedCouriers);
+        }
+
+        //replacedCouriers now contains the old couriers, which the audio thread can't access anymore -> stop them and delete them outside of the lock
+        for (auto* itCourier = replacedCouriers.begin(); itCourier != replacedCouriers.end(); ++itCourier)
         {
             (*itCourier)->stopRunning();
             removeChildComponent(*itCourier);
@@ -432,16 +431,10 @@ void PlayPath::stopPlaying(bool toggleButtonState)
                     }
                 }
             }
-
-            //reset courier's currently intersected regions
-            (*itCourier)->resetCurrentlyIntersectedRegions();
         }
-        couriers.clear(true);
+        replacedCouriers.clear(true);
 
-        //prepare one new courier for the next time that this path is played
-        PlayPathCourier* newCourier = new PlayPathCourier(this, courierIntervalSeconds);
         addChildComponent(newCourier);
-        couriers.add(newCourier);
         repaint(getLocalBounds().expanded(static_cast<int>(PlayPathCourier::radius * 0.5))); //otherwise, the old couriers will appear to stop in place
         //DBG("added a courier. bounds: " + newCourier->getBounds().toString() + " (within " + getLocalBounds().toString() + ")");
 
@@ -503,101 +496,84 @@ void PlayPath::setCourierInterval_seconds(float newCourierIntervalSeconds)
 
 void PlayPath::addIntersectingRegion(SegmentedRegion* region)
 {
-    juce::Range<float> distances(-1.0f, -1.0f);
-    float stepSize = juce::jmax(0.0001, juce::jmin(0.005, 2.0 / 3.0 * (PlayPathCourier::radius / underlyingPath.getLength())));
-    DBG("stepSize: " + juce::String(stepSize));
-
-    //getPointAlongPath returns a point relative to this *PlayPath's* own bounds, but hitTest checks for collision relative to the *SegmentedRegion's* own bounds. so to apply a hitTest to the point, it needs to be shifted according to the difference of the PlayPath's and SegmentedRegion's position in their shared parent component.
-    int xDifference = region->getBoundsInParent().getX() - this->getBoundsInParent().getX(); //difference from the region's x position in its parent compared to this play path's x position in that parent
-    int yDifference = region->getBoundsInParent().getY() - this->getBoundsInParent().getY(); //^- same but for y position
-
-    //check whether the starting point is already contained within the region. if so, begin from the first point not contained within the region. otherwise, begin from the starting point.
-    juce::Point<int> startingPt = getPointAlongPath(0.0f).toInt();
-    float initialDistance = 0.0f;
-    if (region->hitTest_Interactable(startingPt.getX() - xDifference, startingPt.getY() - yDifference))
+    const float pathLength = pathTable.getLength();
+    if (pathLength <= 0.0f)
     {
-        //starting point is already contained within the region
-        //-> the end distance of that section will be found first -> remember for later and add that section last
-        initialDistance = -1.0f;
-
-        for (float distanceFromStart = 0.0f; distanceFromStart < 1.0; distanceFromStart += stepSize)
-        {
-            juce::Point<int> pt = getPointAlongPath(distanceFromStart).toInt();
-            if (!region->hitTest_Interactable(pt.getX() - xDifference, pt.getY() - yDifference)) //note the negation!
-            {
-                //end point found
-                DBG("initial end point: " + pt.toString() + " (" + juce::String(distanceFromStart) + " / " + juce::String(1.0) + ")");
-                initialDistance = distanceFromStart;
-                break;
-            }
-        }
-        if (initialDistance < 0.0f)
-        {
-            //no end point found -> region encompasses the entire path
-            regionsByRange_range.add(juce::Range<float>(0.0f, 1.0f));
-            regionsByRange_region.add(region);
-            return;
-        }
-        //else: initialDistance has been set
+        return;
     }
-    //else: initialDistance is 0.0f
 
-    for (float startDistance = initialDistance; startDistance < 1.0; startDistance += stepSize)
-    {
-        //check current position for collision
-        juce::Point<int> pt = getPointAlongPath(startDistance).toInt();
+    //the region's outline is relative to the *SegmentedRegion's* own bounds, but the path is relative to this *PlayPath's* own bounds. so the outline needs to be shifted according to the difference of the PlayPath's and SegmentedRegion's position in their shared parent component.
+    juce::Point<float> difference = (region->getBoundsInParent().getPosition() - this->getBoundsInParent().getPosition()).toFloat();
+    const juce::Path& outline = region->getOutline();
+
+    //the path can only enter or exit the region where it crosses the region's outline -> find those crossings exactly
+    juce::Array<float> crossings;
+    pathTable.findIntersections(outline, juce::AffineTransform::translation(difference), crossings);
+    crossings.insert(0, 0.0f);
+    crossings.add(pathLength);
 
-        if (region->hitTest_Interactable(pt.getX() - xDifference, pt.getY() - yDifference))
+    //between two crossings, the path is either entirely inside or entirely outside the region -> check the middle of each section and merge adjacent sections that are inside
+    juce::Array<juce::Range<float>> sections;
+    int segmentHint = 0;
+    for (int i = 0; i < crossings.size() - 1; ++i)
+    {
+        float sectionStart = crossings[i];
+        float sectionEnd = crossings[i + 1];
+        if (sectionEnd <= sectionStart)
         {
-            //collision! -> starting point found
-            distances.setStart(startDistance);
-            DBG("start point: " + pt.toString() + " (" + juce::String(startDistance) + " / " + juce::String(1.0) + ")");
+            continue; //several edges crossed at the same point (e.g. a vertex of the outline)
+        }
 
-            //look for end point
-            bool endPointFound = false;
-            for (float endDistance = startDistance + stepSize; endDistance < 1.0; endDistance += stepSize)
+        juce::Point<float> middle = pathTable.getPointAlongPath(0.5f * (sectionStart + sectionEnd), segmentHint) - difference;
+        if (outline.contains(middle))
+        {
+            if (sections.size() > 0 && sections.getLast().getEnd() == sectionStart)
             {
-                //check current position for collision
-                pt = getPointAlongPath(endDistance).toInt();
-
-                if (!region->hitTest_Interactable(pt.getX() - xDifference, pt.getY() - yDifference)) //note the negation!
-                {
-                    //no more collision! -> end point found
-                    endPointFound = true;
-                    distances.setEnd(endDistance);
-                    DBG("end point: " + pt.toString() + " (" + juce::String(endDistance) + " / " + juce::String(1.0) + ")");
-
-                    //add to list
-                    insertIntoRegionsLists(juce::Range<float>(distances), region);
-
-                    //update start distance, reset distance variable and keep looking for more intersections
-                    startDistance = endDistance;
-                    distances = juce::Range<float>(-1.0f, -1.0f);
-                    break;
-                }
+                sections.getReference(sections.size() - 1).setEnd(sectionEnd);
             }
-            if (!endPointFound)
+            else
             {
-                //found a starting point but no end point -> arrived at the last intersection -> loops around
-                distances.setEnd(initialDistance + 1.0); //remembered from the beginning of this method (note that juce::Range.end may not be smaller than juce::Range.start! hence, 1.0 is added to signal the loop-around)
-
-                //add to list
-                insertIntoRegionsLists(juce::Range<float>(distances), region);
-
-                //done searching
-                break;
+                sections.add(juce::Range<float>(sectionStart, sectionEnd));
             }
         }
     }
 
+    if (sections.size() == 0)
+    {
+        return; //no collision
+    }
+    if (sections.size() == 1 && sections[0].getStart() == 0.0f && sections[0].getEnd() == pathLength)
+    {
+        //region encompasses the entire path
+        insertIntoRegionsLists(juce::Range<float>(0.0f, 1.0f), region);
+        return;
+    }
+
+    //if the path starts and ends within the region, the first and the last section are the same one -> loops around
+    //(note that juce::Range.end may not be smaller than juce::Range.start! hence, 1.0 is added to signal the loop-around)
+    if (sections.size() > 1 && sections.getFirst().getStart() == 0.0f && sections.getLast().getEnd() == pathLength)
+    {
+        sections.getReference(sections.size() - 1).setEnd(pathLength + sections.getFirst().getEnd());
+        sections.remove(0);
+    }
+
+    for (auto itSection = sections.begin(); itSection != sections.end(); ++itSection)
+    {
+        DBG("region " + juce::String(region->getID()) + " intersects at [" + juce::String(itSection->getStart() / pathLength) + ", " + juce::String(itSection->getEnd() / pathLength) + "]");
+        insertIntoRegionsLists(juce::Range<float>(itSection->getStart() / pathLength, itSection->getEnd() / pathLength), region);
+    }
 }
 void PlayPath::recalculateAllIntersectingRegions()
 {
     DBG("calculating the range lists...");
 
     auto* availableRegions = &(static_cast<SegmentableImage*>(getParentComponent())->regions);
-    regionsByRange_range.clear();
-    regionsByRange_region.clear();
+    {
+        const juce::SpinLock::ScopedLockType lock(courierLock);
+        regionsByRange_range.clear();
+        regionsByRange_region.clear();
+        invalidateRangeBoundaries();
+    }
 
     for (auto itRegion = availableRegions->begin(); itRegion != availableRegions->end(); ++itRegion)
     {
@@ -621,6 +597,8 @@ void PlayPath::insertIntoRegionsLists(juce::Range<float> regionRange, SegmentedR
         return;
     }
 
+    const juce::SpinLock::ScopedLockType lock(courierLock); //the couriers mustn't move while the lists change
+
     if (regionsByRange_range.size() == 0)
     {
         regionsByRange_range.add(regionRange);
@@ -628,22 +606,30 @@ void PlayPath::insertIntoRegionsLists(juce::Range<float> regionRange, SegmentedR
     }
     else
     {
-        //insert according to starting distance (sorted in ascending order)
-        for (int i = 0; i < regionsByRange_range.size(); ++i)
+        //insert according to starting distance (sorted in ascending order). binary search for the first range that starts later
+        int low = 0;
+        int high = regionsByRange_range.size();
+        while (low < high)
         {
-            if (regionsByRange_range[i].getStart() > regionRange.getStart())
+            int middle = (low + high) / 2;
+            if (regionsByRange_range.getReference(middle).getStart() > regionRange.getStart())
             {
-                regionsByRange_range.insert(i, regionRange);
-                regionsByRange_region.insert(i, region);
-                return;
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
             }
         }
-        regionsByRange_range.add(regionRange);
-        regionsByRange_region.add(region);
+        regionsByRange_range.insert(low, regionRange);
+        regionsByRange_region.insert(low, region);
     }
+    invalidateRangeBoundaries();
 }
 void PlayPath::removeIntersectingRegion(int regionID)
 {
+    const juce::SpinLock::ScopedLockType lock(courierLock); //the couriers mustn't move while the lists change
+
     for (int i = 0; i < regionsByRange_region.size(); ++i)
     {
         if (regionsByRange_region[i]->getID() == regionID)
@@ -654,6 +640,7 @@ void PlayPath::removeIntersectingRegion(int regionID)
             //no break, because regions can be contained a number of times!
         }
     }
+    invalidateRangeBoundaries();
 }
 void PlayPath::evaluateCourierPosition(PlayPathCourier* courier, juce::Range<float> previousPosition, juce::Range<float> newPosition)
 {
@@ -664,29 +651,204 @@ void PlayPath::evaluateCourierPosition(PlayPathCourier* courier, juce::Range<flo
     //     also, this assumption makes the method easier (+ faster) to evaluate and, perhaps even more importantly,
     //     independent from the size of the window containing the path (since couriers have a fixed size for visibility reasons).
 
-    auto itRange = regionsByRange_range.begin();
-    auto itRegion = regionsByRange_region.begin();
+    if (rangeBoundariesOutdated)
+    {
+        rebuildRangeBoundaries(); //doesn't allocate: the storage has been reserved by invalidateRangeBoundaries
+    }
+    if (rangeStarts.size() == 0)
+    {
+        return; //no regions to collide with
+    }
+
+    //the courier enters a range when its front crosses the range's start, and it exits a range when its back crosses the range's end (cf. intersectsWithWraparound).
+    //since both boundaries are sorted, only the boundaries between the courier's previous and new position need to be visited.
+    float previousFront = wrapPosition(previousPosition.getEnd());
+    float previousBack = wrapPosition(previousPosition.getStart());
+    float frontDistance = wrapPosition(newPosition.getEnd() - previousPosition.getEnd()); //moving backwards isn't possible
+    float backDistance = wrapPosition(newPosition.getStart() - previousPosition.getStart());
 
-    for (; itRange != regionsByRange_range.end(); ++itRange, ++itRegion)
+    auto& cursor = courier->getRangeCursor();
+    syncRangeCursor(cursor, previousFront, previousBack);
+
+    crossedStarts.clearQuick();
+    crossedEnds.clearQuick();
+    sweepRangeBoundaries(rangeStarts, cursor.nextStart, previousFront, frontDistance, crossedStarts);
+    sweepRangeBoundaries(rangeEnds, cursor.nextEnd, previousBack, backDistance, crossedEnds);
+
+    //exits first, so that regions that are left free their voices before other regions are entered
+    for (auto itRangeIndex = crossedEnds.begin(); itRangeIndex != crossedEnds.end(); ++itRangeIndex)
     {
-        switch (getCollisionWithRegion(*itRange, previousPosition, newPosition))
+        if (crossedStarts.contains(*itRangeIndex))
         {
-        case CollisionType::entered:
-            //DBG("courier entered region " + juce::String((*itRegion)->getID()) + ".");
-            (*itRegion)->signalCourierEntered();
-            courier->signalRegionEntered((*itRegion)->getID());
-            break;
+            //both entered and exited during the same tick -> skipped a really small strip -> no change
+            crossedStarts.removeFirstMatchingValue(*itRangeIndex);
+            continue;
+        }
 
-        case CollisionType::exited:
-            //DBG("courier left region " + juce::String((*itRegion)->getID()) + ".");
-            (*itRegion)->signalCourierLeft();
-            courier->signalRegionExited((*itRegion)->getID());
-            break;
+        SegmentedRegion* region = regionsByRange_region[*itRangeIndex];
+        //DBG("courier left region " + juce::String(region->getID()) + ".");
+        region->signalCourierLeft();
+        courier->signalRegionExited(region->getID());
+    }
+    for (auto itRangeIndex = crossedStarts.begin(); itRangeIndex != crossedStarts.end(); ++itRangeIndex)
+    {
+        SegmentedRegion* region = regionsByRange_region[*itRangeIndex];
+        //DBG("courier entered region " + juce::String(region->getID()) + ".");
+        region->signalCourierEntered();
+        courier->signalRegionEntered(region->getID());
+    }
+}
+int PlayPath::getSamplesUntilNextCourierEvent(int maxSamples, double sampleRate)
+{
+    const juce::SpinLock::ScopedLockType lock(courierLock);
+
+    if (rangeBoundariesOutdated)
+    {
+        rebuildRangeBoundaries(); //doesn't allocate: the storage has been reserved by invalidateRangeBoundaries
+    }
+    if (rangeStarts.size() == 0)
+    {
+        return maxSamples; //no regions to collide with
+    }
+
+    int samplesUntilNextEvent = maxSamples;
+    for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
+    {
+        double distancePerSample = (*itCourier)->getNormedDistancePerSample(sampleRate);
+        if (!(*itCourier)->getIsRunning() || distancePerSample <= 0.0)
+        {
+            continue;
+        }
+
+        //the next event is either the next range start that the courier's front reaches, or the next range end that its back reaches
+        juce::Range<float> currentPosition = (*itCourier)->getCurrentRange();
+        float front = wrapPosition(currentPosition.getEnd());
+        float back = wrapPosition(currentPosition.getStart());
+
+        auto& cursor = (*itCourier)->getRangeCursor();
+        syncRangeCursor(cursor, front, back);
+
+        float distanceToStart = rangeStarts.getReference(cursor.nextStart).position - front;
+        float distanceToEnd = rangeEnds.getReference(cursor.nextEnd).position - back;
+        distanceToStart += (distanceToStart <= 0.0f) ? 1.0f : 0.0f; //boundary lies behind the wrap-around point
+        distanceToEnd += (distanceToEnd <= 0.0f) ? 1.0f : 0.0f;
+
+        double samplesUntilBoundary = std::ceil(static_cast<double>(juce::jmin(distanceToStart, distanceToEnd)) / distancePerSample);
+        if (samplesUntilBoundary < static_cast<double>(samplesUntilNextEvent))
+        {
+            samplesUntilNextEvent = juce::jmax(1, static_cast<int>(samplesUntilBoundary));
+        }
+    }
+
+    return samplesUntilNextEvent;
+}
+void PlayPath::advanceCouriers(int numSamples, double sampleRate)
+{
+    const juce::SpinLock::ScopedLockType lock(courierLock);
 
-            //default: either no collision or remaining within a region -> no change
+    for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
+    {
+        if ((*itCourier)->getIsRunning())
+        {
+            juce::Range<float> previousPosition, newPosition;
+            (*itCourier)->advance(numSamples, sampleRate, previousPosition, newPosition);
+            evaluateCourierPosition(*itCourier, previousPosition, newPosition); //automatically handles signaling the regions
         }
     }
+}
 
+void PlayPath::invalidateRangeBoundaries()
+{
+    rangeBoundariesOutdated = true;
+
+    //everything that the audio thread fills while evaluating couriers can hold all ranges, so it never needs to allocate
+    int numRanges = regionsByRange_range.size();
+    rangeStarts.ensureStorageAllocated(numRanges);
+    rangeEnds.ensureStorageAllocated(numRanges);
+    crossedStarts.ensureStorageAllocated(numRanges);
+    crossedEnds.ensureStorageAllocated(numRanges);
+    for (auto* itCourier = couriers.begin(); itCourier != couriers.end(); ++itCourier)
+    {
+        (*itCourier)->reserveIntersectedRegions(numRanges);
+    }
+}
+void PlayPath::rebuildRangeBoundaries()
+{
+    rangeStarts.clearQuick();
+    rangeEnds.clearQuick();
+
+    for (int i = 0; i < regionsByRange_range.size(); ++i)
+    {
+        juce::Range<float> range = regionsByRange_range.getReference(i);
+        if (range.getLength() >= 1.0f)
+        {
+            continue; //range covers the entire path -> couriers never enter or exit it
+        }
+
+        rangeStarts.add({ wrapPosition(range.getStart()), i });
+        rangeEnds.add({ wrapPosition(range.getEnd()), i });
+    }
+
+    auto comparePositions = [](const RangeBoundary& a, const RangeBoundary& b) { return a.position < b.position; };
+    std::sort(rangeStarts.begin(), rangeStarts.end(), comparePositions);
+    std::sort(rangeEnds.begin(), rangeEnds.end(), comparePositions);
+
+    rangeBoundariesOutdated = false;
+    ++rangeBoundariesVersion;
+}
+void PlayPath::syncRangeCursor(PlayPathCourier::RangeCursor& cursor, float front, float back)
+{
+    if (cursor.version != rangeBoundariesVersion)
+    {
+        //the courier has just started, or the range lists (or the courier's radius) have changed since it last moved
+        cursor.nextStart = seekRangeBoundary(rangeStarts, front);
+        cursor.nextEnd = seekRangeBoundary(rangeEnds, back);
+        cursor.version = rangeBoundariesVersion;
+    }
+}
+float PlayPath::wrapPosition(float position)
+{
+    return position - std::floor(position);
+}
+int PlayPath::seekRangeBoundary(const juce::Array<RangeBoundary>& boundaries, float position)
+{
+    //binary search for the first boundary that lies after the given position. wraps around to the first boundary if there is none
+    int low = 0;
+    int high = boundaries.size();
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (boundaries.getReference(middle).position > position)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+    return (low < boundaries.size()) ? low : 0;
+}
+void PlayPath::sweepRangeBoundaries(const juce::Array<RangeBoundary>& boundaries, int& cursor, float from, float distance, juce::Array<int>& crossedRangeIndices)
+{
+    //visits all boundaries within (from, from + distance] (wrapping around at 1.0), starting at the cursor, and advances the cursor past them
+    for (int visited = 0; visited < boundaries.size(); ++visited)
+    {
+        const RangeBoundary& boundary = boundaries.getReference(cursor);
+        float distanceToBoundary = boundary.position - from;
+        if (distanceToBoundary <= 0.0f)
+        {
+            distanceToBoundary += 1.0f; //boundary lies behind the wrap-around point
+        }
+
+        if (distanceToBoundary > distance)
+        {
+            break; //not reached yet
+        }
+
+        crossedRangeIndices.add(boundary.rangeIndex);
+        cursor = (cursor + 1) % boundaries.size();
+    }
 }
 PlayPath::CollisionType PlayPath::getCollisionWithRegion(const juce::Range<float>& regionRange, const juce::Range<float>& previousRange, const juce::Range<float>& currentRange)
 {
@@ -835,26 +997,30 @@ void PlayPath::handleNoteOn(juce::MidiKeyboardState* source, int midiChannel, in
             isPlaying_midi = false;
             isPlaying_click = false; //overwrites clicks
 
-            juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                {
-                    static_cast<PlayPath*>(data)->stopPlaying(); //needs to be called on the message thread because the couriers are also running there
-                    return static_cast<void*>(nullptr);
-                }, this);
+            triggerAsyncUpdate(); //stopPlaying needs to be called on the message thread. MIDI usually arrives on the audio thread, which mustn't block
         }
         else
         {
             DBG("MIDI play path");
             isPlaying_midi = true;
 
-            juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                {
-                    static_cast<PlayPath*>(data)->startPlaying(); //needs to be called on the message thread because the couriers are also running there
-                    return static_cast<void*>(nullptr);
-                }, this);
+            triggerAsyncUpdate(); //startPlaying needs to be called on the message thread. MIDI usually arrives on the audio thread, which mustn't block
         }
 
     }
 }
+void PlayPath::handleAsyncUpdate()
+{
+    //apply the latest MIDI state. if the path was toggled several times before this update, only the final state matters
+    if (shouldBePlaying())
+    {
+        startPlaying();
+    }
+    else
+    {
+        stopPlaying();
+    }
+}
 void PlayPath::handleNoteOff(juce::MidiKeyboardState* source, int midiChannel, int midiNoteNumber, float velocity)
 {
     //since play paths are always toggleable, off signals don't need to be handled.
@@ -904,6 +1070,7 @@ bool PlayPath::deserialise(juce::XmlElement* xmlPlayPath)
     ID = xmlPlayPath->getIntAttribute("ID", -1);
     underlyingPath.clear();
     underlyingPath.restoreFromString(xmlPlayPath->getStringAttribute("underlyingPath", ""));
+    pathTable.rebuild(underlyingPath);
     fillColour = juce::Colour::fromString(xmlPlayPath->getStringAttribute("fillColour", juce::Colours::black.toString()));
     fillColourOn = juce::Colour::fromString(xmlPlayPath->getStringAttribute("fillColourOn", fillColour.darker(0.2f).toString()));
     setCourierInterval_seconds(xmlPlayPath->getDoubleAttribute("courierIntervalSeconds", 10.0f));
@@ -936,8 +1103,12 @@ bool PlayPath::deserialise(juce::XmlElement* xmlPlayPath)
     }
 
     //deserialise range lists
-    regionsByRange_range.clear();
-    regionsByRange_region.clear();
+    {
+        const juce::SpinLock::ScopedLockType lock(courierLock);
+        regionsByRange_range.clear();
+        regionsByRange_region.clear();
+        invalidateRangeBoundaries();
+    }
     juce::XmlElement* xmlRangeLists = xmlPlayPath->getChildByName("regionRangeLists");
     auto* availableRegions = &(static_cast<SegmentableImage*>(getParentComponent())->regions);
     if (xmlRangeLists != nullptr)
@@ -964,8 +1135,10 @@ bool PlayPath::deserialise(juce::XmlElement* xmlPlayPath)
                         {
                             //corresponding region found -> add
                             DBG("confirmed.");
+                            const juce::SpinLock::ScopedLockType lock(courierLock);
                             regionsByRange_region.add(*itRegion);
                             regionsByRange_range.add(range);
+                            invalidateRangeBoundaries();
                             break;
                         }
                     }
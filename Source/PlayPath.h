@@ -19,8 +19,9 @@ class PlayPathState;
 class PlayPathEditorWindow;
 
 #include "SegmentedRegion.h"
+#include "PathArcLengthTable.h"
 
-class PlayPath final : public juce::DrawableButton, public juce::MidiKeyboardState::Listener, public juce::TooltipClient
+class PlayPath final : public juce::DrawableButton, public juce::MidiKeyboardState::Listener, public juce::TooltipClient, private juce::AsyncUpdater
 {
 public:
     PlayPath(int ID, const juce::Path& path, const juce::Rectangle<float>& relativeBounds, const juce::Rectangle<int>& parentBounds, juce::Colour fillColour);
@@ -71,7 +72,10 @@ public:
     void addIntersectingRegion(SegmentedRegion* region);
     void recalculateAllIntersectingRegions();
     void removeIntersectingRegion(int regionID);
-    void evaluateCourierPosition(PlayPathCourier* courier, juce::Range<float> previousPosition, juce::Range<float> newPosition);
+
+    //courier motion (audio thread). the couriers are moved in sub-blocks that end exactly where a courier enters or exits a region, so regions are triggered sample-accurately
+    int getSamplesUntilNextCourierEvent(int maxSamples, double sampleRate); //returns maxSamples if no courier will enter or exit a region within that many samples
+    void advanceCouriers(int numSamples, double sampleRate);
 
     int getMidiChannel();
     void setMidiChannel(int newMidiChannel);
@@ -98,6 +102,7 @@ private:
 
     int ID;
     juce::Path underlyingPath;
+    PathArcLengthTable pathTable; //finds points along underlyingPath quickly. rebuilt whenever underlyingPath changes
     float courierIntervalSeconds = 5.0f;
 
     juce::Colour fillColour;
@@ -121,11 +126,33 @@ private:
     int noteNumber = -1; //-1 = none, 0...127 = [note]
 
     juce::OwnedArray<PlayPathCourier> couriers;
+    juce::SpinLock courierLock; //held by the audio thread while moving the couriers, and by the message thread while changing the couriers or the range lists
 
     //keep a double array to remember at which distance from the start of the path a region is entered (much more efficient than searching for components using hitTest since it can be pre-computed)
     juce::Array<juce::Range<float>> regionsByRange_range;
     juce::Array<SegmentedRegion*> regionsByRange_region;
     void insertIntoRegionsLists(juce::Range<float> regionRange, SegmentedRegion* region);
+
+    //sorted sweep structure over the range lists: the positions at which ranges start and end (wrapped into [0, 1)), each sorted in ascending order.
+    //every courier keeps a cursor into both lists, so that each tick only visits the boundaries that the courier has actually crossed.
+    struct RangeBoundary
+    {
+        float position;
+        int rangeIndex; //index within regionsByRange_range and regionsByRange_region
+    };
+    juce::Array<RangeBoundary> rangeStarts;
+    juce::Array<RangeBoundary> rangeEnds;
+    bool rangeBoundariesOutdated = true;
+    int rangeBoundariesVersion = 0; //incremented whenever the boundaries are rebuilt (invalidates the couriers' cursors)
+    juce::Array<int> crossedStarts; //range indices whose starts have been crossed during the current evaluation
+    juce::Array<int> crossedEnds; //range indices whose ends have been crossed during the current evaluation
+    void invalidateRangeBoundaries(); //must be called (while holding courierLock) whenever the range lists change. reserves the storage that the audio thread will need
+    void rebuildRangeBoundaries();
+    static int seekRangeBoundary(const juce::Array<RangeBoundary>& boundaries, float position); //returns the index of the first boundary after position
+    void syncRangeCursor(PlayPathCourier::RangeCursor& cursor, float front, float back);
+    void evaluateCourierPosition(PlayPathCourier* courier, juce::Range<float> previousPosition, juce::Range<float> newPosition);
+    static float wrapPosition(float position); //wraps into [0, 1)
+    static void sweepRangeBoundaries(const juce::Array<RangeBoundary>& boundaries, int& cursor, float from, float distance, juce::Array<int>& crossedRangeIndices);
     
     enum class CollisionType : int
     {
@@ -139,5 +166,7 @@ private:
 
     juce::Component::SafePointer<PlayPathEditorWindow> pathEditorWindow;
 
+    void handleAsyncUpdate() override; //starts or stops the path on the message thread after its MIDI note has been received
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlayPath)
 };
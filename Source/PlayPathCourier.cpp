@@ -28,7 +28,7 @@ PlayPathCourier::PlayPathCourier(PlayPath* associatedPlayPath, float intervalInS
     setMouseClickGrabsKeyboardFocus(false);
 
     //update bounds (without repainting the parent)
-    juce::Point<float> currentPoint = associatedPlayPath->getPointAlongPath(currentNormedDistanceFromStart);
+    juce::Point<float> currentPoint = associatedPlayPath->getPointAlongPath(currentNormedDistanceFromStart.load());
     setBounds(static_cast<int>(currentPoint.getX() - radius),
               static_cast<int>(currentPoint.getY() - radius),
               static_cast<int>(radius * 2.0f),
@@ -52,53 +52,14 @@ void PlayPathCourier::resized()
 
 void PlayPathCourier::timerCallback()
 {
-    double previousNormedDistanceFromStart = currentNormedDistanceFromStart;
-    currentNormedDistanceFromStart = std::fmod(currentNormedDistanceFromStart + normedDistancePerTick, 1.0);
-
-    //check for collisions with any regions
-    //note: since the radius of the courier is quite small, we can assume the path to be approximately linear within the courier's bounds.
-    //      hence, it's alright to assume that the courier always covers an interval [pt - radius, pt + radius]. to account for looping over, modulo is used.
-    juce::Range<float> startingPosition (previousNormedDistanceFromStart - normedRadius, previousNormedDistanceFromStart + normedRadius);
-    juce::Range<float> currentPosition (currentNormedDistanceFromStart - normedRadius, currentNormedDistanceFromStart + normedRadius);
-
-    //wrap values where necessary
-    //(IMPORTANT NOTE: juce::Range enforces that start < end! if values are set so that start>end, the other value will be *moved* to the other value (-> new range length = 0), causing things to break in the context of this use case here!)
-    if (startingPosition.getStart() < 0.0f)
-    {
-        //shift end first, otherwise start would be larger than end, causing juce::Range to break stuff
-        startingPosition.setEnd(startingPosition.getEnd() + 1.0);
-
-        //shift start
-        startingPosition.setStart(startingPosition.getStart() + 1.0);
-    }
-    //if (startingPosition.getEnd() >= 1.0)
-    //{
-    //    startingPosition.setEnd(startingPosition.getEnd() - 1.0);
-    //}
-    if (currentPosition.getStart() < 0.0f)
-    {
-        //shift end first, otherwise start would be larger than end, causing juce::Range to break stuff
-        currentPosition.setEnd(currentPosition.getEnd() + 1.0);
-
-        //shift start
-        currentPosition.setStart(currentPosition.getStart() + 1.0);
-    }
-    //if (currentPosition.getEnd() >= 1.0)
-    //{
-    //    currentPosition.setEnd(currentPosition.getEnd() - 1.0);
-    //}
-
-    //DBG("[" + juce::String(currentPosition.getStart()) + ", " + juce::String(currentPosition.getEnd()) + "]");
-    associatedPlayPath->evaluateCourierPosition(this, startingPosition, currentPosition); //automatically handles signaling the regions
-
-    //update position on screen
+    //the courier is moved by the audio thread -> only update its position on screen
     updateBounds();
 }
 void PlayPathCourier::updateBounds()
 {
     juce::Rectangle<int> previousBounds = getBounds();
 
-    juce::Point<float> currentPoint = associatedPlayPath->getPointAlongPath(currentNormedDistanceFromStart);
+    juce::Point<float> currentPoint = associatedPlayPath->getPointAlongPath(currentNormedDistanceFromStart.load());
     setBounds(static_cast<int>(currentPoint.getX() - radius),
               static_cast<int>(currentPoint.getY() - radius),
               static_cast<int>(radius * 2.0f),
@@ -110,41 +71,94 @@ void PlayPathCourier::updateBounds()
 
 float PlayPathCourier::getInterval_seconds()
 {
-    return intervalInSeconds;
+    return intervalInSeconds.load();
 }
 void PlayPathCourier::setInterval_seconds(float newIntervalInSeconds)
 {
-    intervalInSeconds = newIntervalInSeconds;
-    normedDistancePerTick = 1.0 / static_cast<double>(intervalInSeconds * tickRateInHz); //= (1.0 / intervalInSeconds) / tickRateInHz
-    //DBG("new normedDistancePerTick: " + juce::String(normedDistancePerTick));
+    intervalInSeconds.store(newIntervalInSeconds);
 }
 
 juce::Range<float> PlayPathCourier::getCurrentRange()
 {
-    return juce::Range<float>(currentNormedDistanceFromStart - normedRadius, currentNormedDistanceFromStart + normedRadius);
+    return getWrappedRange(currentNormedDistanceFromStart.load(), normedRadius.load());
+}
+double PlayPathCourier::getNormedRadius()
+{
+    return normedRadius.load();
+}
+double PlayPathCourier::getNormedDistanceFromStart()
+{
+    return currentNormedDistanceFromStart.load();
 }
 
 void PlayPathCourier::parentPathLengthChanged()
 {
     if (associatedPlayPath->getPathLength() > 0)
     {
-        normedRadius = radius / associatedPlayPath->getPathLength();
+        normedRadius.store(radius / associatedPlayPath->getPathLength());
     }
     else
     {
-        normedRadius = 0.0;
+        normedRadius.store(0.0);
     }
-    //DBG("new normedRadius: " + juce::String(normedRadius));
+    rangeCursor.version = -1; //the courier's front and back have moved -> the cursor needs to be sought again
+    //DBG("new normedRadius: " + juce::String(normedRadius.load()));
 }
 
 void PlayPathCourier::startRunning()
 {
-    startTimerHz(tickRateInHz);
+    currentNormedDistanceFromStart.store(0.0);
+    rangeCursor.version = -1;
+    isRunning.store(true);
+
+    startTimerHz(static_cast<int>(redrawRateInHz));
 }
 void PlayPathCourier::stopRunning()
 {
+    isRunning.store(false);
     stopTimer();
-    currentNormedDistanceFromStart = 0.0;
+    currentNormedDistanceFromStart.store(0.0);
+    rangeCursor.version = -1; //jumped back to the start -> cursor needs to be sought again
+}
+bool PlayPathCourier::getIsRunning()
+{
+    return isRunning.load();
+}
+
+void PlayPathCourier::advance(int numSamples, double sampleRate, juce::Range<float>& previousRange, juce::Range<float>& newRange)
+{
+    double previousNormedDistanceFromStart = currentNormedDistanceFromStart.load();
+    double newNormedDistanceFromStart = std::fmod(previousNormedDistanceFromStart + static_cast<double>(numSamples) * getNormedDistancePerSample(sampleRate), 1.0);
+    currentNormedDistanceFromStart.store(newNormedDistanceFromStart);
+
+    //note: since the radius of the courier is quite small, we can assume the path to be approximately linear within the courier's bounds.
+    //      hence, it's alright to assume that the courier always covers an interval [pt - radius, pt + radius].
+    double currentNormedRadius = normedRadius.load();
+    previousRange = getWrappedRange(previousNormedDistanceFromStart, currentNormedRadius);
+    newRange = getWrappedRange(newNormedDistanceFromStart, currentNormedRadius);
+}
+double PlayPathCourier::getNormedDistancePerSample(double sampleRate)
+{
+    double samplesPerLap = static_cast<double>(intervalInSeconds.load()) * sampleRate;
+    return (samplesPerLap > 0.0) ? (1.0 / samplesPerLap) : 0.0;
+}
+
+juce::Range<float> PlayPathCourier::getWrappedRange(double normedDistanceFromStart, double normedRadius)
+{
+    juce::Range<float> range(static_cast<float>(normedDistanceFromStart - normedRadius), static_cast<float>(normedDistanceFromStart + normedRadius));
+
+    //wrap values where necessary. to account for looping over, the range is shifted by one lap if it starts before the start of the path
+    //(IMPORTANT NOTE: juce::Range enforces that start < end! if values are set so that start>end, the other value will be *moved* to the other value (-> new range length = 0), causing things to break in the context of this use case here!)
+    if (range.getStart() < 0.0f)
+    {
+        //shift end first, otherwise start would be larger than end, causing juce::Range to break stuff
+        range.setEnd(range.getEnd() + 1.0f);
+
+        //shift start
+        range.setStart(range.getStart() + 1.0f);
+    }
+
+    return range;
 }
 
 void PlayPathCourier::signalRegionEntered(int regionID)
@@ -153,16 +167,7 @@ void PlayPathCourier::signalRegionEntered(int regionID)
 }
 void PlayPathCourier::signalRegionExited(int regionID)
 {
-    int i = 0;
-    for (auto itID = currentlyIntersectedRegions.begin(); itID != currentlyIntersectedRegions.end(); ++itID)
-    {
-        if (*itID == regionID)
-        {
-            //found the region to remove
-            currentlyIntersectedRegions.remove(i);
-            break; //should only be contained once
-        }
-    }
+    currentlyIntersectedRegions.removeFirstMatchingValue(regionID); //should only be contained once
 }
 juce::Array<int> PlayPathCourier::getCurrentlyIntersectedRegions()
 {
@@ -173,5 +178,14 @@ juce::Array<int> PlayPathCourier::getCurrentlyIntersectedRegions()
 }
 void PlayPathCourier::resetCurrentlyIntersectedRegions()
 {
-    currentlyIntersectedRegions.clear();
+    currentlyIntersectedRegions.clearQuick(); //keeps the reserved storage
+}
+void PlayPathCourier::reserveIntersectedRegions(int numRegions)
+{
+    currentlyIntersectedRegions.ensureStorageAllocated(numRegions);
+}
+
+PlayPathCourier::RangeCursor& PlayPathCourier::getRangeCursor()
+{
+    return rangeCursor;
 }
@@ -11,9 +11,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 
 class PlayPath;
 
+/// <summary>
+/// Point that travels around a play path and plays the regions that it passes.
+/// The courier is moved by the audio thread (see PlayPath::advanceCouriers), so that regions are entered and exited sample-accurately.
+/// The component itself only redraws the courier at its current position, which it reads lock-free.
+/// </summary>
 class PlayPathCourier final : public juce::Component, juce::Timer
 {
 public:
@@ -30,32 +36,57 @@ public:
     void setInterval_seconds(float newIntervalInSeconds);
 
     juce::Range<float> getCurrentRange();
+    double getNormedRadius();
+    double getNormedDistanceFromStart();
 
     void parentPathLengthChanged();
 
     void startRunning();
     void stopRunning();
+    bool getIsRunning();
+
+    /// <summary>
+    /// Moves the courier along its path. Must only be called by the associated play path (audio thread).
+    /// </summary>
+    /// <param name="previousRange">Receives the range that the courier covered before it moved</param>
+    /// <param name="newRange">Receives the range that the courier covers now</param>
+    void advance(int numSamples, double sampleRate, juce::Range<float>& previousRange, juce::Range<float>& newRange);
+    double getNormedDistancePerSample(double sampleRate);
 
     void signalRegionEntered(int regionID);
     void signalRegionExited(int regionID);
     juce::Array<int> getCurrentlyIntersectedRegions();
     void resetCurrentlyIntersectedRegions();
+    void reserveIntersectedRegions(int numRegions); //avoids allocations on the audio thread. must not be called while the courier is running
+
+    /// <summary>
+    /// Position of the courier within the sorted range boundaries of its play path (see PlayPath::evaluateCourierPosition).
+    /// </summary>
+    struct RangeCursor
+    {
+        int nextStart = 0; //index of the next range start that the courier's front will cross
+        int nextEnd = 0; //index of the next range end that the courier's back will cross
+        int version = -1; //version of the boundaries that the indices refer to. if it's outdated, the indices are sought again
+    };
+    RangeCursor& getRangeCursor();
 
     static const float radius;
 
 private:
     PlayPath* associatedPlayPath = nullptr;
-    double currentNormedDistanceFromStart = 0.0;
+    std::atomic<double> currentNormedDistanceFromStart { 0.0 }; //written by the audio thread, read by the UI
 
-    float intervalInSeconds = 0.0f;
-    float tickRateInHz = 20.0f;
-    double normedDistancePerTick = 0.0;
+    std::atomic<float> intervalInSeconds { 0.0f };
+    float redrawRateInHz = 30.0f; //the courier only moves on the audio thread. this is merely the rate at which its position on screen is updated
 
-    double normedRadius = 0.0;
+    std::atomic<double> normedRadius { 0.0 };
 
-    bool isRunning = false;
+    std::atomic<bool> isRunning { false };
 
     juce::Array<int> currentlyIntersectedRegions;
+    RangeCursor rangeCursor;
+
+    static juce::Range<float> getWrappedRange(double normedDistanceFromStart, double normedRadius);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlayPathCourier)
-};
\ No newline at end of file
+};
@@ -60,6 +60,12 @@ ImageINeDemoAudioProcessorEditor::ImageINeDemoAudioProcessorEditor (ImageINeDemo
     informationButton.onClick = [this] { displayModeInformation(); };
     informationButton.setTooltip("Click here to display some information about the current program mode, useful keybindings et cetera.");
     addAndMakeVisible(informationButton);
+
+    //engine settings button
+    engineSettingsButton.setButtonText("Engine");
+    engineSettingsButton.onClick = [this] { showEngineSettingsMenu(); };
+    engineSettingsButton.setTooltip("Click here to change settings of the audio engine that apply to all regions, e.g. how many voices may sound at the same time and which voices are faded out when that limit is reached.");
+    addAndMakeVisible(engineSettingsButton);
     
     //load image button
     openImageButton.setButtonText("Open Image");
@@ -143,6 +149,7 @@ void ImageINeDemoAudioProcessorEditor::resized()
     openPresetButton.setBounds(headerArea.removeFromLeft(widthQuarter).reduced(2));
     savePresetButton.setBounds(headerArea.removeFromLeft(widthQuarter).reduced(2));
     informationButton.setBounds(headerArea.removeFromRight(20).reduced(2));
+    engineSettingsButton.setBounds(headerArea.removeFromRight(60).reduced(2));
     midiInputList.setBounds(headerArea.reduced(2));
 
     juce::Rectangle<int> modeArea;
@@ -839,6 +846,42 @@ void ImageINeDemoAudioProcessorEditor::panic()
     audioProcessor.audioEngine.panic();
 }
 
+void ImageINeDemoAudioProcessorEditor::showEngineSettingsMenu()
+{
+    auto* voicePool = audioProcessor.audioEngine.getVoicePool();
+
+    //global voice limit
+    juce::PopupMenu voiceLimitMenu;
+    voiceLimitMenu.addItem("Unlimited", true, voicePool->getMaxActiveVoices() == VoicePool::unlimitedVoices, [voicePool] { voicePool->setMaxActiveVoices(VoicePool::unlimitedVoices); });
+    for (int limit = 8; limit <= 128; limit *= 2)
+    {
+        voiceLimitMenu.addItem(juce::String(limit) + " Voices", true, voicePool->getMaxActiveVoices() == limit, [voicePool, limit] { voicePool->setMaxActiveVoices(limit); });
+    }
+
+    //voice stealing policy
+    juce::PopupMenu stealingPolicyMenu;
+    auto currentPolicy = voicePool->getStealingPolicy();
+    stealingPolicyMenu.addItem("Oldest", true, currentPolicy == VoiceStealingPolicy::oldest, [voicePool] { voicePool->setStealingPolicy(VoiceStealingPolicy::oldest); });
+    stealingPolicyMenu.addItem("Quietest", true, currentPolicy == VoiceStealingPolicy::quietest, [voicePool] { voicePool->setStealingPolicy(VoiceStealingPolicy::quietest); });
+    stealingPolicyMenu.addItem("Releasing First", true, currentPolicy == VoiceStealingPolicy::releasingFirst, [voicePool] { voicePool->setStealingPolicy(VoiceStealingPolicy::releasingFirst); });
+
+    //number of threads that render voices alongside the audio thread
+    juce::PopupMenu renderThreadsMenu;
+    auto* audioEngine = &audioProcessor.audioEngine;
+    int currentNumRenderThreads = audioEngine->getNumRenderThreads();
+    for (int numThreads = 0; numThreads <= AudioEngine::getDefaultNumRenderThreads(); ++numThreads)
+    {
+        juce::String text = (numThreads == 0) ? "Off (audio thread only)" : juce::String(numThreads) + (numThreads == 1 ? " Thread" : " Threads");
+        renderThreadsMenu.addItem(text, true, currentNumRenderThreads == numThreads, [audioEngine, numThreads] { audioEngine->setNumRenderThreads(numThreads); });
+    }
+
+    juce::PopupMenu menu;
+    menu.addSubMenu("Voice Limit", voiceLimitMenu);
+    menu.addSubMenu("Voice Stealing", stealingPolicyMenu);
+    menu.addSubMenu("Render Threads", renderThreadsMenu);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&engineSettingsButton));
+}
+
 void ImageINeDemoAudioProcessorEditor::setMidiInput(int index)
 {
     auto list = juce::MidiInput::getAvailableDevices();
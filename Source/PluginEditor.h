@@ -62,6 +62,8 @@ private:
 
     void displayModeInformation();
 
+    void showEngineSettingsMenu();
+
     //==============================================================================
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -76,6 +78,8 @@ private:
 
     juce::TextButton informationButton;
 
+    juce::TextButton engineSettingsButton;
+
     PluginEditorStateIndex currentStateIndex = PluginEditorStateIndex::null;
 
     juce::Label modeLabel;
@@ -19,6 +19,7 @@ RegionEditor::RegionEditor(SegmentedRegion* region) :
     lfoEditor(region->getAudioEngine(), region->getAssociatedLfo())
 {
     associatedRegion = region;
+    lfoEditor.onRateChanged = [this] { associatedRegion->lfoRateChanged(); }; //the wavetable may need to be band-limited (or may not need to be anymore)
 
     //file selection
     selectFileButton.setButtonText("Select Sound File");
@@ -226,6 +227,19 @@ RegionEditor::RegionEditor(SegmentedRegion* region) :
     addChildComponent(playbackPositionIntervalLabel);
     playbackPositionIntervalLabel.attachToComponent(&playbackPositionIntervalSlider, true);
 
+    //interpolation
+    interpolationChoice.addItem("None", static_cast<int>(InterpolationMethod::none) + 1); //always adding 1 because 0 is not a valid ID (reserved for other purposes)
+    interpolationChoice.addItem("Linear", static_cast<int>(InterpolationMethod::linear) + 1);
+    interpolationChoice.addItem("Cubic", static_cast<int>(InterpolationMethod::cubic) + 1);
+    interpolationChoice.addItem("Windowed Sinc", static_cast<int>(InterpolationMethod::windowedSinc) + 1);
+    interpolationChoice.onChange = [this] { updateInterpolationMethod(); };
+    interpolationChoice.setTooltip("Here you can select how your audio file is read between its samples when it's pitched. None is the cheapest but sounds harsh, Linear is a good compromise, and Cubic and Windowed Sinc sound cleaner, but need more CPU.");
+    addChildComponent(interpolationChoice);
+
+    interpolationLabel.setText("Interpolation: ", juce::NotificationType::dontSendNotification);
+    addChildComponent(interpolationLabel);
+    interpolationLabel.attachToComponent(&interpolationChoice, true);
+
     //filter type
     filterTypeChoice.addItem("Lowpass", static_cast<int>(juce::dsp::StateVariableFilter::StateVariableFilterType::lowPass) + 1);
     filterTypeChoice.addItem("Bandpass", static_cast<int>(juce::dsp::StateVariableFilter::StateVariableFilterType::bandPass) + 1);
@@ -310,6 +324,22 @@ RegionEditor::RegionEditor(SegmentedRegion* region) :
     midiNoteLabel.attachToComponent(&midiNoteChoice, true);
     addChildComponent(midiNoteLabel);
 
+    //polyphony
+    for (int i = 1; i <= AudioEngine::maxPolyphony; ++i)
+    {
+        polyphonyChoice.addItem(juce::String(i), i);
+    }
+    polyphonyChoice.onChange = [this]
+    {
+        associatedRegion->setPolyphony(polyphonyChoice.getSelectedId());
+    };
+    polyphonyChoice.setTooltip("Here you can select how many voices this region can play at the same time (e.g. while earlier notes are still releasing). If all of them are busy, one of them is faded out quickly and played again.");
+    addChildComponent(polyphonyChoice);
+
+    polyphonyLabel.setText("Polyphony: ", juce::NotificationType::dontSendNotification);
+    polyphonyLabel.attachToComponent(&polyphonyChoice, true);
+    addChildComponent(polyphonyLabel);
+
 
     //LFO editor
     lfoEditor.setTooltip("This is the LFO editor.");
@@ -326,14 +356,13 @@ RegionEditor::RegionEditor(SegmentedRegion* region) :
     setChildVisibility(true);
 
     setSize(350, 700);
-
-    formatManager.registerBasicFormats();
 }
 
 RegionEditor::~RegionEditor()
 {
     DBG("destroying RegionEditor...");
 
+    cancelLoadingFile(); //otherwise, the loader's callbacks would access this editor after its deletion
     associatedRegion = nullptr;
 
     DBG("RegionEditor destroyed.");
@@ -349,7 +378,7 @@ void RegionEditor::paint(juce::Graphics& g)
     
     //normal
     auto area = getLocalBounds();
-    int hUnit = juce::jmin(50, juce::jmax(5, static_cast<int>(static_cast<float>(getHeight()) * 0.75 / 23.0))); //unit of height required to squeeze all elements into 75% of the window's area (the remaining 25% are used for the modulation table)
+    int hUnit = juce::jmin(50, juce::jmax(5, static_cast<int>(static_cast<float>(getHeight()) * 0.75 / 25.0))); //unit of height required to squeeze all elements into 75% of the window's area (the remaining 25% are used for the modulation table)
 
     area.removeFromTop(hUnit);
     area.removeFromTop(hUnit); //selectFileButton.setBounds(area.removeFromTop(hUnit).reduced(2));
@@ -378,6 +407,7 @@ void RegionEditor::paint(juce::Graphics& g)
     //normal
     auto playbackPosStartArea = area.removeFromTop(hUnit);
     auto playbackPosIntervalArea = area.removeFromTop(hUnit);
+    auto interpolationArea = area.removeFromTop(hUnit);
 
     //brighter
     auto filterTypeArea = area.removeFromTop(hUnit);
@@ -389,6 +419,10 @@ void RegionEditor::paint(juce::Graphics& g)
     auto midiArea = area.removeFromTop(hUnit);
     midiArea = area.removeFromTop(hUnit);
 
+    //brighter
+    auto polyphonyArea = area.removeFromTop(hUnit);
+    g.fillRect(polyphonyArea);
+
     area.removeFromBottom(hUnit); //randomiseButton.setBounds(area.removeFromBottom(hUnit).reduced(1));
 
     ////LFO editor: handled there
@@ -402,7 +436,7 @@ void RegionEditor::paint(juce::Graphics& g)
 void RegionEditor::resized()
 {
     auto area = getLocalBounds();
-    int hUnit = juce::jmin(50, juce::jmax(5, static_cast<int>(static_cast<float>(getHeight()) * 0.75 / 23.0))); //unit of height required to squeeze all elements into 75% of the window's area (the remaining 25% are used for the modulation table)
+    int hUnit = juce::jmin(50, juce::jmax(5, static_cast<int>(static_cast<float>(getHeight()) * 0.75 / 25.0))); //unit of height required to squeeze all elements into 75% of the window's area (the remaining 25% are used for the modulation table)
 
     area.removeFromTop(hUnit);
     selectFileButton.setBounds(area.removeFromTop(hUnit).reduced(2));
@@ -442,6 +476,9 @@ void RegionEditor::resized()
     playbackPositionIntervalSlider.setBounds(playbackPosIntervalArea.removeFromRight(2 * playbackPosIntervalArea.getWidth() / 3).reduced(1));
     playbackPositionIntervalSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, false, playbackPositionStartSlider.getWidth(), playbackPositionStartSlider.getHeight()); //this may look redundant, but the tooltip won't display unless this is done...
 
+    auto interpolationArea = area.removeFromTop(hUnit);
+    interpolationChoice.setBounds(interpolationArea.removeFromRight(2 * interpolationArea.getWidth() / 3).reduced(2));
+
     auto filterTypeArea = area.removeFromTop(hUnit);
     filterTypeChoice.setBounds(filterTypeArea.removeFromRight(2 * filterTypeArea.getWidth() / 3).reduced(2));
 
@@ -454,6 +491,9 @@ void RegionEditor::resized()
     midiArea = area.removeFromTop(hUnit);
     midiNoteChoice.setBounds(midiArea.removeFromRight(2 * midiArea.getWidth() / 3).reduced(2));
 
+    auto polyphonyArea = area.removeFromTop(hUnit);
+    polyphonyChoice.setBounds(polyphonyArea.removeFromRight(2 * polyphonyArea.getWidth() / 3).reduced(2));
+
     randomiseButton.setBounds(area.removeFromBottom(hUnit).reduced(1));
 
     lfoEditor.setUnitOfHeight(hUnit);
@@ -569,6 +609,9 @@ void RegionEditor::setChildVisibility(bool shouldBeVisible)
     playbackPositionIntervalLabel.setVisible(shouldBeVisible);
     playbackPositionIntervalSlider.setVisible(shouldBeVisible);
 
+    interpolationLabel.setVisible(shouldBeVisible);
+    interpolationChoice.setVisible(shouldBeVisible);
+
     filterTypeChoice.setVisible(shouldBeVisible);
     filterTypeLabel.setVisible(shouldBeVisible);
 
@@ -580,6 +623,9 @@ void RegionEditor::setChildVisibility(bool shouldBeVisible)
     midiNoteChoice.setVisible(shouldBeVisible);
     midiNoteLabel.setVisible(shouldBeVisible);
 
+    polyphonyChoice.setVisible(shouldBeVisible);
+    polyphonyLabel.setVisible(shouldBeVisible);
+
     lfoEditor.setVisible(shouldBeVisible);
 
     randomiseButton.setVisible(shouldBeVisible);
@@ -615,6 +661,7 @@ void RegionEditor::copyRegionParameters()
 
         playbackPositionStartSlider.setValue(voice->getBasePlaybackPositionStart(), juce::NotificationType::dontSendNotification);
         playbackPositionIntervalSlider.setValue(voice->getBasePlaybackPositionInterval(), juce::NotificationType::dontSendNotification);
+        interpolationChoice.setSelectedId(static_cast<int>(voice->getInterpolationMethod()) + 1, juce::NotificationType::dontSendNotification);
 
         filterTypeChoice.setSelectedId(static_cast<int>(voice->getFilterType()) + 1, juce::NotificationType::dontSendNotification);
         filterPositionSlider.setValue(voice->getBaseFilterPosition(), juce::NotificationType::dontSendNotification);
@@ -634,6 +681,7 @@ void RegionEditor::copyRegionParameters()
         midiChannelChoice.setSelectedId(midiChannel + 1, juce::NotificationType::dontSendNotification);
     }
     midiNoteChoice.setSelectedId(associatedRegion->getMidiNote(), juce::NotificationType::dontSendNotification);
+    polyphonyChoice.setSelectedId(associatedRegion->getPolyphony(), juce::NotificationType::dontSendNotification);
 
     lfoEditor.updateAvailableVoices();
     lfoEditor.copyParameters();
@@ -647,9 +695,16 @@ void RegionEditor::selectFile()
 {
     //shutdownAudio();
 
-    fc = std::make_unique<juce::FileChooser>("Select a Wave file shorter than 2 seconds to play...",
+    if (currentLoadID >= 0)
+    {
+        //a file is currently being loaded -> the button cancels that instead
+        cancelLoadingFile();
+        return;
+    }
+
+    fc = std::make_unique<juce::FileChooser>("Select an audio file to play (long files are streamed from disk)...",
         juce::File(/*R"(C:\Users\Aaron\Desktop\Musikproduktion\VSTs\Iris 2\Iris 2 Library\Samples)"*/),
-        formatManager.getWildcardForAllFormats());
+        associatedRegion->getAudioEngine()->getFileLoader()->getWildcardForAllFormats());
     auto chooserFlags = juce::FileBrowserComponent::openMode
         | juce::FileBrowserComponent::canSelectFiles;
 
@@ -660,52 +715,92 @@ void RegionEditor::selectFile()
             if (file == juce::File{})
                 return;
 
-            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
-
-            if (reader.get() != nullptr)
-            {
-                auto duration = (float)reader->lengthInSamples / reader->sampleRate;
-
-                associatedRegion->getAudioEngine()->suspendProcessing(true); //pause the audio engine to ensure that loading the file doesn't change the audio thread's priority
-
-                //juce::AudioSampleBuffer tempBuffer();
-                tempBuffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
-                reader->read(&tempBuffer,
-                    0,
-                    (int)reader->lengthInSamples,
-                    0,
-                    true,
-                    true);
-                //position = 0;
-                //setAudioChannels(0, (int)reader->numChannels);
-
-                associatedRegion->setBuffer(tempBuffer, file.getFileName(), reader->sampleRate);
-                selectedFileLabel.setText(file.getFileName(), juce::NotificationType::dontSendNotification);
-
-                lfoEditor.updateAvailableVoices();
-                updateAllVoiceSettings(); //sets currently selected volume, pitch etc.
-
-                juce::Array<DahdsrEnvelope*> associatedEnvelopes;
-                juce::Array<Voice*> associatedVoices = associatedRegion->getAssociatedVoices();
-                for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
-                {
-                    associatedEnvelopes.add((*itVoice)->getEnvelope());
-                }
-                dahdsrEditor.setAssociatedEnvelopes(associatedEnvelopes);
-
-                copyRegionParameters(); //updates pitch quantisation, makes sure nothing's missing
-
-                associatedRegion->getAudioEngine()->suspendProcessing(false);
-            }
-            else
-            {
-                juce::NativeMessageBox::showMessageBoxAsync(
-                    juce::MessageBoxIconType::WarningIcon,
-                    "ImageINe - unknown format",
-                    "The file couldn't be opened. This is most likely because the format isn't supported.",
-                    this, nullptr);
-            }
+            startLoadingFile(file);
+        });
+}
+void RegionEditor::startLoadingFile(const juce::File& file)
+{
+    //the file is decoded on a background thread, so that neither the UI nor the audio engine have to wait for it.
+    //the callbacks are called on the message thread and never after cancelLoadingFile (which is also called by the destructor), so capturing this is safe.
+    auto fileName = file.getFileName();
+    currentLoadID = associatedRegion->getAudioEngine()->getFileLoader()->loadFile(file,
+        [this, fileName](float progress)
+        {
+            selectedFileLabel.setText("Loading " + fileName + "... " + juce::String(juce::roundToInt(progress * 100.0f)) + "%", juce::NotificationType::dontSendNotification);
+        },
+        [this](juce::AudioSampleBuffer& buffer, const juce::String& loadedFileName, double sampleRate)
+        {
+            fileLoadingFinished();
+            fileLoaded(buffer, loadedFileName, sampleRate);
+        },
+        [this](StreamingAudioFile::Ptr stream, const juce::String& loadedFileName)
+        {
+            fileLoadingFinished();
+            fileStreamed(stream, loadedFileName);
+        },
+        [this](const juce::String& errorMessage)
+        {
+            fileLoadingFinished();
+            juce::NativeMessageBox::showMessageBoxAsync(
+                juce::MessageBoxIconType::WarningIcon,
+                "ImageINe - file couldn't be loaded",
+                errorMessage,
+                this, nullptr);
         });
+
+    selectedFileLabel.setText("Loading " + fileName + "...", juce::NotificationType::dontSendNotification);
+    selectFileButton.setButtonText("Cancel Loading");
+    selectFileButton.setTooltip("Click here to stop loading the file. The region will keep playing its previous file.");
+}
+void RegionEditor::cancelLoadingFile()
+{
+    if (currentLoadID < 0)
+    {
+        return;
+    }
+
+    associatedRegion->getAudioEngine()->getFileLoader()->cancel(currentLoadID);
+    fileLoadingFinished();
+}
+void RegionEditor::fileLoaded(juce::AudioSampleBuffer& buffer, const juce::String& fileName, double sampleRate)
+{
+    auto sample = associatedRegion->getAudioEngine()->getSampleStore()->add(buffer, sampleRate); //if another region already uses the same file, its sample is shared
+    associatedRegion->setSample(sample, fileName); //only now the region's voices change their file
+    fileChanged(fileName);
+}
+void RegionEditor::fileStreamed(StreamingAudioFile::Ptr stream, const juce::String& fileName)
+{
+    associatedRegion->setStream(stream, fileName); //only now the region's voices change their file
+    fileChanged(fileName + " (streamed)");
+}
+void RegionEditor::fileChanged(const juce::String& fileName)
+{
+    selectedFileLabel.setText(fileName, juce::NotificationType::dontSendNotification);
+
+    lfoEditor.updateAvailableVoices();
+    updateAllVoiceSettings(); //sets currently selected volume, pitch etc.
+
+    juce::Array<DahdsrEnvelope*> associatedEnvelopes;
+    juce::Array<Voice*> associatedVoices = associatedRegion->getAssociatedVoices();
+    for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
+    {
+        associatedEnvelopes.add((*itVoice)->getEnvelope());
+    }
+    dahdsrEditor.setAssociatedEnvelopes(associatedEnvelopes);
+
+    copyRegionParameters(); //updates pitch quantisation, makes sure nothing's missing
+}
+void RegionEditor::fileLoadingFinished()
+{
+    currentLoadID = -1;
+
+    selectFileButton.setButtonText("Select Sound File");
+    selectFileButton.setTooltip("Click here to select an audio file for the region to play.");
+
+    if (associatedRegion->getFileName() == "")
+        selectedFileLabel.setText("Please select a file", juce::NotificationType::dontSendNotification);
+    else
+        selectedFileLabel.setText("Selected file: " + associatedRegion->getFileName(), juce::NotificationType::dontSendNotification);
 }
 
 void RegionEditor::updateFocusPosition()
@@ -848,6 +943,16 @@ void RegionEditor::randomisePlaybackPositionInterval()
     }
 }
 
+void RegionEditor::updateInterpolationMethod()
+{
+    juce::Array<Voice*> voices = associatedRegion->getAudioEngine()->getVoicesWithID(associatedRegion->getID());
+
+    for (auto* it = voices.begin(); it != voices.end(); it++)
+    {
+        (*it)->setInterpolationMethod(static_cast<InterpolationMethod>(interpolationChoice.getSelectedId() - 1));
+    }
+}
+
 void RegionEditor::updateFilterType()
 {
     juce::Array<Voice*> voices = associatedRegion->getAudioEngine()->getVoicesWithID(associatedRegion->getID());
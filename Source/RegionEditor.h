@@ -41,6 +41,12 @@ private:
     void copyRegionParameters();
 
     void selectFile();
+    void startLoadingFile(const juce::File& file);
+    void cancelLoadingFile();
+    void fileLoaded(juce::AudioSampleBuffer& buffer, const juce::String& fileName, double sampleRate);
+    void fileStreamed(StreamingAudioFile::Ptr stream, const juce::String& fileName);
+    void fileChanged(const juce::String& fileName); //updates the editor and the voices' settings after the region's file has changed
+    void fileLoadingFinished(); //called after loading has finished, failed or been cancelled
 
     void updateFocusPosition();
     void randomiseFocusPosition();
@@ -65,6 +71,8 @@ private:
     void updatePlaybackPositionInterval();
     void randomisePlaybackPositionInterval();
 
+    void updateInterpolationMethod(); //not randomised: it's a matter of quality vs. CPU load rather than of sound design
+
     void updateFilterType();
     void randomiseFilterType();
 
@@ -103,6 +111,9 @@ private:
     juce::Label playbackPositionIntervalLabel;
     juce::Slider playbackPositionIntervalSlider;
 
+    juce::Label interpolationLabel;
+    juce::ComboBox interpolationChoice;
+
     juce::Label filterTypeLabel;
     juce::ComboBox filterTypeChoice;
     juce::Label filterPositionLabel;
@@ -113,13 +124,15 @@ private:
     juce::Label midiNoteLabel;
     juce::ComboBox midiNoteChoice;
 
+    juce::Label polyphonyLabel;
+    juce::ComboBox polyphonyChoice;
+
     LfoEditor lfoEditor;
 
     juce::TextButton randomiseButton;
 
     std::unique_ptr<juce::FileChooser> fc;
-    juce::AudioFormatManager formatManager;
-    juce::AudioSampleBuffer tempBuffer;
+    int currentLoadID = -1; //ID of the file that's currently being loaded by the AudioEngine's AudioFileLoader (-1 if none)
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RegionEditor)
 };
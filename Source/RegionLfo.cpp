@@ -18,7 +18,6 @@ const float RegionLfo::defaultUpdateIntervalMs = 10.0f;
 
 RegionLfo::RegionLfo(int regionID) :
     Lfo(juce::AudioSampleBuffer(), [](float) {; }), //can only initialise waveTable through the base class's constructor...
-    waveTableUnipolar(0, 0),
     frequencyModParameter(0.0),
     startingPhaseModParameter(0.0), phaseIntervalModParameter(1.0, 0.001), currentPhaseModParameter(0.0),
     updateIntervalParameter(1.0)
@@ -42,7 +41,8 @@ RegionLfo::RegionLfo(int regionID) :
 RegionLfo::RegionLfo(const juce::AudioBuffer<float>& waveTable, Polarity polarityOfPassedWaveTable, int regionID) :
     RegionLfo(regionID)
 {
-    setWaveTable(waveTable, polarityOfPassedWaveTable); //calculates buffers for both unipolar and bipolar version of the wavetable
+    setWaveTable(waveTable, polarityOfPassedWaveTable); //converts the wavetable to bipolar if necessary
+    applyPendingWaveTable(); //the LFO hasn't been added to the AudioEngine yet, so the wavetable can be applied right away
 }
 
 RegionLfo::~RegionLfo()
@@ -118,7 +118,6 @@ RegionLfo::~RegionLfo()
     int deletedStates = 6;
     jassert(deletedStates == static_cast<int>(RegionLfoStateIndex::StateIndexCount));
 
-    //waveTableUnipolar.setSize(0, 0); //not necessary
     //waveTable.setSize(0, 0); //not necessary
 
     //Lfo::~Lfo(); //this causes a heap exception for some reason -> don't do it
@@ -128,24 +127,37 @@ RegionLfo::~RegionLfo()
 
 void RegionLfo::setWaveTable(const juce::AudioBuffer<float>& waveTable, Polarity polarityOfPassedWaveTable)
 {
-    //the waveTable member of the base class is hereby defined to be exclusively bipolar, waveTableUnipolar will be unipolar
+    //the waveTable member of the base class is hereby defined to be exclusively bipolar. the unipolar values are derived from it (see interpolateCurrentValues)
+    //the table is built here (on the message thread), so that the audio thread only needs to swap it in
+    auto* newWaveTable = new WaveTableSnapshot();
+    newWaveTable->waveTable.makeCopyOf(waveTable);
 
     switch (polarityOfPassedWaveTable)
     {
     case Polarity::unipolar:
-        this->waveTableUnipolar.makeCopyOf(waveTable);
-        calculateBipolarWaveTable();
+        convertUnipolarToBipolar(newWaveTable->waveTable);
         break;
 
     case Polarity::bipolar:
-        this->waveTable.makeCopyOf(waveTable);
-        calculateUnipolarWaveTable();
         break;
 
     default:
+        delete newWaveTable;
         throw std::exception("invalid polarity");
     }
 
+    waveTableExchange.publish(newWaveTable);
+}
+void RegionLfo::applyPendingWaveTable()
+{
+    if (!waveTableExchange.collect(appliedWaveTableSnapshot))
+    {
+        return; //no new wavetable
+    }
+
+    //swapping buffers only exchanges their pointers (no allocation). afterwards, the snapshot contains the previous table.
+    std::swap(waveTable, appliedWaveTableSnapshot->waveTable);
+
     setBaseFrequency(baseFrequency);
     resetPhase();
 
@@ -154,6 +166,7 @@ void RegionLfo::setWaveTable(const juce::AudioBuffer<float>& waveTable, Polarity
 
 void RegionLfo::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    applyPendingWaveTable(); //the audio thread isn't running during prepare, so any wavetable that has been set in the meantime can be applied right away
     Lfo::prepare(spec);
     currentState->prepared(spec.sampleRate);
 }
@@ -285,6 +298,20 @@ int RegionLfo::getNumModulatedParameterIDs()
 {
     return modulatedParameterIDs.size();
 }
+juce::Array<ModulatableParameter<double>*> RegionLfo::getModulatedParameters(int modulationIndex) //modulationIndex: index within getAffectedRegionIDs() / getModulatedParameterIDs()
+{
+    juce::Array<ModulatableParameter<double>*> output;
+    if (modulationIndex >= 0 && modulationIndex < modulatedParameters.size())
+    {
+        output.addArray(*modulatedParameters[modulationIndex]);
+    }
+    return output;
+}
+
+bool RegionLfo::checkAndResetUpdated()
+{
+    return hasUpdated.exchange(false, std::memory_order_relaxed);
+}
 
 ModulatableAdditiveParameter<double>* RegionLfo::getFrequencyModParameter()
 {
@@ -481,6 +508,66 @@ void RegionLfo::advanceUnsafeWithoutUpdate()
     ////update phase
     //updateLatestModulatedPhase(); //required to keep the LFO line updated
 }
+void RegionLfo::advanceUnsafeWithDeferredUpdate()
+{
+    //doesn't check whether the wavetable actually contains samples, saving one if case per sample
+
+    evaluateFrequencyModulation();
+    evaluateTablePosModulation(); //increments currentTablePos if required
+
+    //the phase interval is needed right away (it's the wrap length for the rest of the block), but wrapping the phase and interpolating the wavetables
+    //is left to the RegionLfoBatch, which does it for all LFOs that updated during this control step at once. the values are only read between sub-blocks anyway
+    latestModulatedStartingPhase = startingPhaseModParameter.getModulatedValue();
+    latestModulatedPhaseInterval = phaseIntervalModParameter.getModulatedValue();
+    pendingEvaluationTablePos = currentTablePos;
+    pendingEvaluation = true;
+
+    updateModulatedParameterUnsafe();
+}
+void RegionLfo::advanceBlock(int numSamples)
+{
+    currentState->advanceBlock(numSamples);
+}
+bool RegionLfo::claimControlStep(juce::uint32 step)
+{
+    if (lastClaimedControlStep == step)
+    {
+        return false; //already advanced during this step
+    }
+
+    lastClaimedControlStep = step;
+    return true;
+}
+bool RegionLfo::hasClaimedControlStep(juce::uint32 step)
+{
+    return lastClaimedControlStep == step;
+}
+void RegionLfo::advanceBlockUnsafeWithoutUpdate(int numSamples)
+{
+    //same as calling advanceUnsafeWithoutUpdate numSamples times, but in constant time
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    evaluateFrequencyModulation(); //the frequency modulation doesn't change during the block
+
+    double modulatedTablePos = currentTablePos;
+    if (currentPhaseModParameter.modulateValueIfUpdated(&modulatedTablePos)) //true if it updated the value
+    {
+        //first sample: stick to the target phase (see evaluateTablePosModulation)
+        currentTablePos = static_cast<float>(std::fmod(modulatedTablePos, 1.0)) * static_cast<float>(getNumSamplesUnsafe() - 1);
+        --numSamples;
+    }
+
+    //all other samples advance by tablePosDelta, wrapping around at the phase interval
+    currentTablePos += tablePosDelta * static_cast<float>(numSamples);
+    float wrapLength = latestModulatedPhaseInterval * static_cast<float>(waveTable.getNumSamples() - 1); //-1 because the last sample is equal to the first
+    if (currentTablePos >= wrapLength && wrapLength > 0.0f)
+    {
+        currentTablePos = std::fmod(currentTablePos, wrapLength);
+    }
+}
 
 void RegionLfo::setPhase(float relativeTablePos)
 {
@@ -831,15 +918,27 @@ void RegionLfo::updateCurrentValues() //pre-calculates the current LFO values (u
     float effectiveTablePos = static_cast<float>(latestModulatedPhase) * static_cast<float>(getNumSamplesUnsafe() - 1); //convert phase back to index within wavetable (-1 at the end to ensure that floating-point rounding won't let the variable take on out-of-range values!)
     //^- 2 mod, 1 mult, 1 div -> slightly better
 
+    interpolateCurrentValues(effectiveTablePos);
+}
+void RegionLfo::interpolateCurrentValues(float effectiveTablePos)
+{
     int sampleIndex1 = static_cast<int>(effectiveTablePos);
     int sampleIndex2 = sampleIndex1 + 1;
     float frac = effectiveTablePos - static_cast<float>(sampleIndex1);
 
-    auto* samplesUnipolar = waveTableUnipolar.getReadPointer(0);
-    currentValueUnipolar = samplesUnipolar[sampleIndex1] + frac * (samplesUnipolar[sampleIndex2] - samplesUnipolar[sampleIndex1]); //interpolate between samples (good especially at slower freqs)
-
-    auto* samplesBipolar = waveTable.getReadPointer(0);
-    currentValueBipolar = samplesBipolar[sampleIndex1] + frac * (samplesBipolar[sampleIndex2] - samplesBipolar[sampleIndex1]); //interpolate between samples (good especially at slower freqs)
+    auto* samples = waveTable.getReadPointer(0);
+    currentValueBipolar = samples[sampleIndex1] + frac * (samples[sampleIndex2] - samples[sampleIndex1]); //interpolate between samples (good especially at slower freqs)
+    currentValueUnipolar = (currentValueBipolar + 1.0f) * 0.5f; //re-normalise from [-1,1] to [0,1]. interpolation is linear, so this equals interpolating a unipolar table
+}
+bool RegionLfo::hasPendingEvaluation()
+{
+    return pendingEvaluation;
+}
+void RegionLfo::applyEvaluatedPhase(float phase, float effectiveTablePos)
+{
+    latestModulatedPhase = phase; //keeps the LFO line updated
+    interpolateCurrentValues(effectiveTablePos);
+    pendingEvaluation = false;
 }
 void RegionLfo::updateLatestModulatedPhase()
 {
@@ -861,48 +960,21 @@ void RegionLfo::updateModulatedParameter()
 {
     if (waveTable.getNumSamples() > 0)
     {
-        auto itParamArrays = modulatedParameters.begin();
-        for (auto itRegion = affectedRegionIDs.begin(); itRegion != affectedRegionIDs.end(); ++itRegion, ++itParamArrays) //iterate over all affected regions
-        {
-            auto regionParams = *itParamArrays;
-            for (auto itParam = regionParams->begin(); itParam != regionParams->end(); ++itParam)
-            {
-                (*itParam)->signalModulatorUpdated(); //signal an update to all modulated parameters of that region
-            }
-        }
+        updateModulatedParameterUnsafe();
     }
 }
 void RegionLfo::updateModulatedParameterUnsafe()
 {
-    auto itParamArrays = modulatedParameters.begin();
-    for (auto itRegion = affectedRegionIDs.begin(); itRegion != affectedRegionIDs.end(); ++itRegion, ++itParamArrays) //iterate over all affected regions
-    {
-        auto regionParams = *itParamArrays;
-        for (auto itParam = regionParams->begin(); itParam != regionParams->end(); ++itParam)
-        {
-            (*itParam)->signalModulatorUpdated(); //signal an update to all modulated parameters of that region
-        }
-    }
+    //the modulated parameters aren't signalled directly anymore. instead, the ModulationMatrix evaluates all parameters affected by updated LFOs in one pass per control tick.
+    hasUpdated.store(true, std::memory_order_relaxed);
 }
 
-void RegionLfo::calculateUnipolarWaveTable()
-{
-    waveTableUnipolar.makeCopyOf(waveTable);
-    auto samples = waveTableUnipolar.getWritePointer(0);
-
-    //re-normalise from [0,1] to [-1,1]
-    for (int i = 0; i < waveTableUnipolar.getNumSamples(); ++i)
-    {
-        samples[i] = (samples[i] + 1.0f) * 0.5f;
-    }
-}
-void RegionLfo::calculateBipolarWaveTable()
+void RegionLfo::convertUnipolarToBipolar(juce::AudioBuffer<float>& table)
 {
-    waveTable.makeCopyOf(waveTableUnipolar);
-    auto samples = waveTable.getWritePointer(0);
+    auto samples = table.getWritePointer(0);
 
     //re-normalise from [0,1] to [-1,1]
-    for (int i = 0; i < waveTable.getNumSamples(); ++i)
+    for (int i = 0; i < table.getNumSamples(); ++i)
     {
         samples[i] = samples[i] * 2.0f - 1.0f;
     }
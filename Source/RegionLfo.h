@@ -27,6 +27,7 @@ class RegionLfoState_Active;
 #include "UpdateRateQuantisationMethod.h"
 
 #include "ModulatableParameter.h"
+#include "SnapshotExchange.h"
 
 
 /// <summary>
@@ -45,7 +46,8 @@ public:
     RegionLfo(const juce::AudioBuffer<float>& waveTable, Polarity polarityOfPassedWaveTable, int regionID);
     ~RegionLfo();
 
-    void setWaveTable(const juce::AudioBuffer<float>& waveTable, Polarity polarityOfPassedWaveTable);
+    void setWaveTable(const juce::AudioBuffer<float>& waveTable, Polarity polarityOfPassedWaveTable); //the new wavetable is picked up by applyPendingWaveTable
+    void applyPendingWaveTable(); //called by the audio thread at the beginning of every block (or by the message thread while the LFO isn't being processed)
 
     void prepare(const juce::dsp::ProcessSpec& spec) override;
 
@@ -54,6 +56,9 @@ public:
     juce::Array<int> getAffectedRegionIDs();
     juce::Array<LfoModulatableParameter> getModulatedParameterIDs();
     int getNumModulatedParameterIDs();
+    juce::Array<ModulatableParameter<double>*> getModulatedParameters(int modulationIndex);
+
+    bool checkAndResetUpdated();
 
     ModulatableAdditiveParameter<double>* getFrequencyModParameter();
     ModulatableAdditiveParameter<double>* getStartingPhaseModParameter();
@@ -71,6 +76,15 @@ public:
     void advance() override;
     void advanceUnsafeWithUpdate();
     void advanceUnsafeWithoutUpdate();
+    void advanceUnsafeWithDeferredUpdate(); //like advanceUnsafeWithUpdate, but leaves calculating the LFO's values to a RegionLfoBatch (see hasPendingEvaluation)
+    /// <summary>
+    /// Advances the LFO by the given number of samples. Equivalent to calling advance() that many times, but the table position is jumped forward in closed form,
+    /// and the LFO's values are only calculated at its update points. Modulations are applied between sub-blocks, so they are constant during the call.
+    /// </summary>
+    void advanceBlock(int numSamples);
+    void advanceBlockUnsafeWithoutUpdate(int numSamples);
+    bool claimControlStep(juce::uint32 step); //returns true the first time that it's called for a step, false afterwards. lets the AudioEngine advance the LFO only once per step
+    bool hasClaimedControlStep(juce::uint32 step);
 
     void setPhase(float relativeTablePos) override;
     float getPhase() override;
@@ -83,6 +97,7 @@ public:
 
     void updateLatestModulatedPhase();
     void updateCurrentValues();
+    bool hasPendingEvaluation(); //true if the LFO has updated via advanceUnsafeWithDeferredUpdate, but its values haven't been calculated yet
 
     double getCurrentValue_Unipolar();
     double getCurrentValue_Bipolar();
@@ -113,6 +128,8 @@ public:
     //void deserialise_mods(juce::XmlElement* xmlLfo);
 
 protected:
+    friend class RegionLfoBatch; //gathers the inputs of pending evaluations and writes back their results
+
     int regionID; //ID of the region that this LFO is associated with
 
     //states
@@ -128,12 +145,32 @@ protected:
     juce::OwnedArray<juce::Array<ModulatableParameter<double>*>> modulatedParameters; //may modulate several voices of one region - hence, the additional wrapping array
     juce::Array<LfoModulatableParameter> modulatedParameterIDs;
     juce::Array<int> affectedRegionIDs;
+    std::atomic<bool> hasUpdated { false }; //set whenever the LFO's value updates. the ModulationMatrix then re-evaluates all parameters modulated by this LFO during its next tick
+    juce::uint32 lastClaimedControlStep = 0; //only accessed by the audio thread
 
-    //unipolar/bipolar stuff
-    juce::AudioBuffer<float> waveTableUnipolar; //the Lfo::waveTable member is treated as being bipolar
+    //unipolar/bipolar stuff: the Lfo::waveTable member is treated as being bipolar. unipolar values are derived from the bipolar ones, so only one table needs to be stored and interpolated
+
+    /// <summary>
+    /// Bipolar version of a wavetable, built by setWaveTable on the message thread. When applied, the table is swapped with the LFO's current table,
+    /// so that the snapshot then contains the previous table (which will be released by the message thread).
+    /// </summary>
+    struct WaveTableSnapshot : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<WaveTableSnapshot>;
+
+        juce::AudioBuffer<float> waveTable;
+    };
+    SnapshotExchange<WaveTableSnapshot> waveTableExchange;
+    WaveTableSnapshot::Ptr appliedWaveTableSnapshot; //contains the table replaced by the last applied snapshot
 
     float currentValueUnipolar = 0.0f;
     float currentValueBipolar = 0.0f;
+    void interpolateCurrentValues(float effectiveTablePos);
+
+    //deferred updates (see advanceUnsafeWithDeferredUpdate)
+    float pendingEvaluationTablePos = 0.0f; //currentTablePos at the latest deferred update
+    bool pendingEvaluation = false; //only accessed by the audio thread
+    void applyEvaluatedPhase(float phase, float effectiveTablePos); //called by RegionLfoBatch
 
     //other
     ModulatableAdditiveParameter<double> frequencyModParameter; //replaces the frequency modulation members of LFO
@@ -164,6 +201,5 @@ protected:
     void updateModulatedParameter() override;
     void updateModulatedParameterUnsafe();
 
-    void calculateUnipolarWaveTable();
-    void calculateBipolarWaveTable();
+    static void convertUnipolarToBipolar(juce::AudioBuffer<float>& table); //in place
 };
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    RegionLfoBatch.cpp
+    Created: 17 Oct 2026 8:42:15pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "RegionLfoBatch.h"
+
+//constants
+const float RegionLfoBatch::maxPhase = 1.0f - std::numeric_limits<float>::epsilon();
+
+
+
+
+RegionLfoBatch::RegionLfoBatch()
+{ }
+RegionLfoBatch::~RegionLfoBatch()
+{ }
+
+void RegionLfoBatch::reserve(int maxNumLfos)
+{
+    if (maxNumLfos <= capacity)
+    {
+        return;
+    }
+
+    capacity = maxNumLfos;
+    lfos.ensureStorageAllocated(capacity);
+    tablePositions.realloc(capacity);
+    tableLengths.realloc(capacity);
+    phaseIntervals.realloc(capacity);
+    startingPhases.realloc(capacity);
+    phases.realloc(capacity);
+}
+
+void RegionLfoBatch::add(RegionLfo* lfo)
+{
+    if (!lfo->hasPendingEvaluation())
+    {
+        return;
+    }
+
+    if (lfos.size() == capacity)
+    {
+        evaluate(); //shouldn't happen (every LFO is added at most once per batch), but never allocate on the audio thread
+    }
+    lfos.add(lfo);
+}
+
+void RegionLfoBatch::evaluate()
+{
+    const int numLfos = lfos.size();
+
+    //gather
+    for (int i = 0; i < numLfos; ++i)
+    {
+        RegionLfo* lfo = lfos.getUnchecked(i);
+        tablePositions[i] = lfo->pendingEvaluationTablePos;
+        tableLengths[i] = static_cast<float>(lfo->getNumSamplesUnsafe());
+        phaseIntervals[i] = lfo->latestModulatedPhaseInterval;
+        startingPhases[i] = lfo->latestModulatedStartingPhase;
+    }
+
+    //effectivePhase = (((currentTablePos/numSamples) mod phaseInterval) + startingPhase) mod 1.0 (see RegionLfo::updateLatestModulatedPhase)
+    //the mods are expressed via floor, so that there are no branches or library calls that would keep the compiler from vectorising these loops
+    for (int i = 0; i < numLfos; ++i)
+    {
+        float phase = tablePositions[i] / tableLengths[i];
+        phase -= std::floor(phase / phaseIntervals[i]) * phaseIntervals[i];
+        phase += startingPhases[i];
+        phase -= std::floor(phase); //unlike fmod, this also wraps negative starting phases into [0,1)
+        phases[i] = juce::jmin(phase, maxPhase);
+    }
+    for (int i = 0; i < numLfos; ++i)
+    {
+        tablePositions[i] = phases[i] * (tableLengths[i] - 1.0f); //-1 because the last sample is equal to the first
+    }
+
+    //interpolate and scatter (the table lookups can't be vectorised since every LFO has its own wavetable)
+    for (int i = 0; i < numLfos; ++i)
+    {
+        lfos.getUnchecked(i)->applyEvaluatedPhase(phases[i], tablePositions[i]);
+    }
+
+    lfos.clearQuick();
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    RegionLfoBatch.h
+    Created: 17 Oct 2026 8:42:15pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RegionLfo.h"
+
+/// <summary>
+/// Calculates the values of many RegionLfos at once. During advanceBlock, the LFOs only remember their table position at their latest update point
+/// (see RegionLfo::advanceUnsafeWithDeferredUpdate). The batch gathers these inputs of all LFOs that updated during a control step into structure-of-arrays form,
+/// wraps all their phases in branchless loops that the compiler can vectorise, and then interpolates the wavetables and writes the values back into the LFOs.
+/// Apart from reserve, all methods must only be called from the audio thread while holding the synth's lock.
+/// </summary>
+class RegionLfoBatch
+{
+public:
+    RegionLfoBatch();
+    ~RegionLfoBatch();
+
+    void reserve(int maxNumLfos); //must be called whenever an LFO is added (while holding the synth's lock), so that the audio thread never allocates
+
+    void add(RegionLfo* lfo); //adds the LFO if it has a pending evaluation
+    void evaluate(); //calculates the values of all added LFOs and clears the batch
+
+private:
+    juce::Array<RegionLfo*> lfos;
+    int capacity = 0;
+
+    //structure of arrays, one element per added LFO
+    juce::HeapBlock<float> tablePositions; //input: table position at the latest update. output: effective table position
+    juce::HeapBlock<float> tableLengths;
+    juce::HeapBlock<float> phaseIntervals;
+    juce::HeapBlock<float> startingPhases;
+    juce::HeapBlock<float> phases;
+
+    static const float maxPhase; //largest phase below 1.0, so that the second interpolation index stays within the wavetable
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RegionLfoBatch)
+};
@@ -57,6 +57,10 @@ void RegionLfoState_Unprepared::advance()
 {
     //doesn't do anything while unprepared
 }
+void RegionLfoState_Unprepared::advanceBlock(int numSamples)
+{
+    //doesn't do anything while unprepared
+}
 
 float RegionLfoState_Unprepared::getPhase()
 {
@@ -122,6 +126,10 @@ void RegionLfoState_WithoutWaveTable::advance()
 {
     //doesn't do anything while wave table hasn't been set
 }
+void RegionLfoState_WithoutWaveTable::advanceBlock(int numSamples)
+{
+    //doesn't do anything while wave table hasn't been set
+}
 
 float RegionLfoState_WithoutWaveTable::getPhase()
 {
@@ -196,6 +204,21 @@ void RegionLfoState_WithoutModulatedParameters::advance()
         lfo.resetSamplesUntilUpdate();
     }
 }
+void RegionLfoState_WithoutModulatedParameters::advanceBlock(int numSamples)
+{
+    //the phase only needs to be updated whenever samplesUntilUpdate reaches 0 -> jump from one of those points to the next
+    while (numSamples > lfo.samplesUntilUpdate)
+    {
+        int samplesToUpdate = lfo.samplesUntilUpdate + 1; //the update happens during the sample at which samplesUntilUpdate == 0
+        lfo.advanceBlockUnsafeWithoutUpdate(samplesToUpdate);
+        lfo.updateLatestModulatedPhase();
+        lfo.resetSamplesUntilUpdate();
+        numSamples -= samplesToUpdate;
+    }
+
+    lfo.advanceBlockUnsafeWithoutUpdate(numSamples);
+    lfo.samplesUntilUpdate -= numSamples;
+}
 
 float RegionLfoState_WithoutModulatedParameters::getPhase()
 {
@@ -274,6 +297,21 @@ void RegionLfoState_Muted::advance()
         lfo.resetSamplesUntilUpdate();
     }
 }
+void RegionLfoState_Muted::advanceBlock(int numSamples)
+{
+    //the phase only needs to be updated whenever samplesUntilUpdate reaches 0 -> jump from one of those points to the next
+    while (numSamples > lfo.samplesUntilUpdate)
+    {
+        int samplesToUpdate = lfo.samplesUntilUpdate + 1; //the update happens during the sample at which samplesUntilUpdate == 0
+        lfo.advanceBlockUnsafeWithoutUpdate(samplesToUpdate);
+        lfo.updateLatestModulatedPhase();
+        lfo.resetSamplesUntilUpdate();
+        numSamples -= samplesToUpdate;
+    }
+
+    lfo.advanceBlockUnsafeWithoutUpdate(numSamples);
+    lfo.samplesUntilUpdate -= numSamples;
+}
 
 float RegionLfoState_Muted::getPhase()
 {
@@ -354,6 +392,20 @@ void RegionLfoState_Active::advance()
         lfo.resetSamplesUntilUpdate();
     }
 }
+void RegionLfoState_Active::advanceBlock(int numSamples)
+{
+    //the LFO's values only need to be calculated whenever samplesUntilUpdate reaches 0 -> jump from one of those points to the next
+    while (numSamples > lfo.samplesUntilUpdate)
+    {
+        lfo.advanceBlockUnsafeWithoutUpdate(lfo.samplesUntilUpdate);
+        numSamples -= lfo.samplesUntilUpdate + 1;
+        lfo.advanceUnsafeWithDeferredUpdate(); //the sample at which samplesUntilUpdate == 0. the values are calculated by the AudioEngine's RegionLfoBatch after the block
+        lfo.resetSamplesUntilUpdate();
+    }
+
+    lfo.advanceBlockUnsafeWithoutUpdate(numSamples);
+    lfo.samplesUntilUpdate -= numSamples;
+}
 
 float RegionLfoState_Active::getPhase()
 {
@@ -435,6 +487,15 @@ void RegionLfoState_ActiveRealTime::advance()
     //doesn't need to check for samplesUntilUpdate -> saves 1 if case
     lfo.advanceUnsafeWithUpdate();
 }
+void RegionLfoState_ActiveRealTime::advanceBlock(int numSamples)
+{
+    //the LFO would update during every sample, but its values are only read between sub-blocks (by the ModulationMatrix) -> only the last update matters
+    if (numSamples > 0)
+    {
+        lfo.advanceBlockUnsafeWithoutUpdate(numSamples - 1);
+        lfo.advanceUnsafeWithDeferredUpdate(); //the values are calculated by the AudioEngine's RegionLfoBatch after the block
+    }
+}
 
 float RegionLfoState_ActiveRealTime::getPhase()
 {
@@ -29,6 +29,7 @@ public:
     virtual void modulatedParameterCountChanged(int newCount) = 0;
 
     virtual void advance() = 0;
+    virtual void advanceBlock(int numSamples) = 0; //same as calling advance() numSamples times
 
     virtual float getPhase() = 0;
     virtual void setPhase(float relativeTablePos) = 0;
@@ -54,6 +55,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
@@ -75,6 +77,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
@@ -96,6 +99,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
@@ -117,6 +121,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
@@ -138,6 +143,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
@@ -159,6 +165,7 @@ public:
     void modulatedParameterCountChanged(int newCount) override;
 
     void advance() override;
+    void advanceBlock(int numSamples) override;
 
     float getPhase() override;
     void setPhase(float relativeTablePos) override;
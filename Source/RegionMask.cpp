@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    RegionMask.cpp
+    Created: 17 Oct 2026 9:47:03pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "RegionMask.h"
+#include "PathArcLengthTable.h"
+
+RegionMask::RegionMask()
+{ }
+
+void RegionMask::rebuild(const juce::Path& path, int width, int height)
+{
+    this->width = juce::jmax(0, width);
+    this->height = juce::jmax(0, height);
+    wordsPerRow = (this->width + 31) / 32;
+    bits.calloc(static_cast<size_t>(juce::jmax(1, wordsPerRow * this->height)));
+
+    juce::Array<juce::Line<float>> edges;
+    PathArcLengthTable::collectClosedEdges(path, juce::AffineTransform(), edges); //open sub-paths are closed, because juce::Path::contains treats them as closed, too
+
+    //scanline fill: for every row, find where the edges cross it and fill the spans in between according to the winding rule
+    struct Crossing
+    {
+        float x;
+        int direction; //+1: edge goes downwards, -1: edge goes upwards
+    };
+    juce::Array<Crossing> crossings;
+    const bool useNonZeroWinding = path.isUsingNonZeroWinding();
+
+    for (int y = 0; y < this->height; ++y)
+    {
+        const float rowY = static_cast<float>(y); //the mask answers queries for integer coordinates, so the rows are sampled there, too
+        crossings.clearQuick();
+
+        for (auto& edge : edges)
+        {
+            float y1 = edge.getStartY();
+            float y2 = edge.getEndY();
+            if (y1 == y2 || rowY < juce::jmin(y1, y2) || rowY >= juce::jmax(y1, y2))
+            {
+                continue; //horizontal or doesn't cross this row
+            }
+
+            float x = edge.getStartX() + (rowY - y1) * (edge.getEndX() - edge.getStartX()) / (y2 - y1);
+            crossings.add({ x, (y2 > y1) ? 1 : -1 });
+        }
+
+        std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) { return a.x < b.x; });
+
+        int winding = 0;
+        for (int i = 0; i < crossings.size() - 1; ++i)
+        {
+            winding += crossings.getReference(i).direction;
+            bool isInside = useNonZeroWinding ? (winding != 0) : ((winding & 1) != 0);
+
+            if (isInside)
+            {
+                int startX = static_cast<int>(std::ceil(crossings.getReference(i).x));
+                int endX = static_cast<int>(std::ceil(crossings.getReference(i + 1).x));
+                fillSpan(y, juce::jmax(0, startX), juce::jmin(this->width, endX));
+            }
+        }
+    }
+}
+
+bool RegionMask::contains(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width || y >= height)
+    {
+        return false;
+    }
+
+    return (bits[y * wordsPerRow + (x >> 5)] & (1u << (x & 31))) != 0;
+}
+
+void RegionMask::fillSpan(int y, int startX, int endX)
+{
+    juce::uint32* row = bits.get() + y * wordsPerRow;
+
+    for (int x = startX; x < endX; )
+    {
+        int bit = x & 31;
+        int numBits = juce::jmin(32 - bit, endX - x);
+        juce::uint32 mask = (numBits == 32) ? 0xffffffffu : (((1u << numBits) - 1u) << bit);
+        row[x >> 5] |= mask;
+        x += numBits;
+    }
+}
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    RegionMask.h
+    Created: 17 Oct 2026 9:47:03pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/// <summary>
+/// Rasterised version of a filled path: one bit per pixel, stating whether that pixel lies within the path.
+/// juce::Path::contains tests the point against every edge of the path. This mask is built once per size of the path (scanline fill over its flattened edges)
+/// and then answers containment queries for integer coordinates in constant time.
+/// Uses the path's winding rule, and treats all sub-paths as closed, just like juce::Path::contains.
+/// </summary>
+class RegionMask
+{
+public:
+    RegionMask();
+
+    void rebuild(const juce::Path& path, int width, int height); //must be called whenever the path or its size changes
+
+    bool contains(int x, int y) const; //false for points outside of [0, width) x [0, height)
+
+private:
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    juce::HeapBlock<juce::uint32> bits; //row by row, 32 pixels per word
+
+    void fillSpan(int y, int startX, int endX); //endX is exclusive
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RegionMask)
+};
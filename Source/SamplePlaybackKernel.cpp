@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    SamplePlaybackKernel.cpp
+    Created: 17 Oct 2026 10:14:03am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "SamplePlaybackKernel.h"
+
+SamplePlaybackKernel::interpolationFuncPt SamplePlaybackKernel::getInterpolationFunction(InterpolationMethod method)
+{
+    switch (method)
+    {
+    case InterpolationMethod::none:
+        return &SamplePlaybackKernel::readTruncated;
+
+    case InterpolationMethod::linear:
+        return &SamplePlaybackKernel::readLinear;
+
+    case InterpolationMethod::cubic:
+        return &SamplePlaybackKernel::readCubic;
+
+    case InterpolationMethod::windowedSinc:
+        getSincTable(); //makes sure that the table is calculated now and not on the audio thread
+        return &SamplePlaybackKernel::readWindowedSinc;
+
+    default:
+        throw std::exception("unhandled interpolation method");
+    }
+}
+
+void SamplePlaybackKernel::readTruncated(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        destination[i] = source[static_cast<int>(readPositions[i])];
+    }
+}
+
+void SamplePlaybackKernel::readLinear(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples)
+{
+    //index + 1 never needs to be wrapped: the read position is smaller than numSourceSamples - 1.
+    //the indices are still clamped, so that buffers with fewer than 2 samples (which can't contain such a position) are never read out of bounds
+    int lastIndex = juce::jmax(0, numSourceSamples - 1);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        int index = juce::jmin(static_cast<int>(readPositions[i]), lastIndex);
+        int nextIndex = juce::jmin(index + 1, lastIndex);
+        float frac = static_cast<float>(readPositions[i] - static_cast<double>(index));
+        destination[i] = source[index] + frac * (source[nextIndex] - source[index]);
+    }
+}
+
+void SamplePlaybackKernel::readCubic(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples)
+{
+    int wrapLength = juce::jmax(1, numSourceSamples - 1);
+    int lastIndex = juce::jmax(0, numSourceSamples - 1); //see readLinear
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        int index = juce::jmin(static_cast<int>(readPositions[i]), lastIndex);
+        float frac = static_cast<float>(readPositions[i] - static_cast<double>(index));
+
+        float xm1 = source[wrapIndex(index - 1, wrapLength)];
+        float x0 = source[index];
+        float x1 = source[juce::jmin(index + 1, lastIndex)];
+        float x2 = source[wrapIndex(index + 2, wrapLength)];
+
+        //4-point, 3rd-order Hermite (x-form)
+        float c1 = 0.5f * (x1 - xm1);
+        float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+        float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+        destination[i] = ((c3 * frac + c2) * frac + c1) * frac + x0;
+    }
+}
+
+void SamplePlaybackKernel::readWindowedSinc(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples)
+{
+    const float* sincTable = getSincTable();
+    int wrapLength = juce::jmax(1, numSourceSamples - 1);
+    const int halfTaps = sincNumTaps / 2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        int index = static_cast<int>(readPositions[i]);
+        int phase = static_cast<int>((readPositions[i] - static_cast<double>(index)) * static_cast<double>(sincNumPhases));
+        const float* coefficients = sincTable + phase * sincNumTaps;
+
+        float sum = 0.0f;
+        if (index >= halfTaps - 1 && index + halfTaps < wrapLength)
+        {
+            //no wrapping required (by far the most common case)
+            const float* samples = source + index - (halfTaps - 1);
+            for (int tap = 0; tap < sincNumTaps; ++tap)
+            {
+                sum += samples[tap] * coefficients[tap];
+            }
+        }
+        else
+        {
+            for (int tap = 0; tap < sincNumTaps; ++tap)
+            {
+                sum += source[wrapIndex(index - (halfTaps - 1) + tap, wrapLength)] * coefficients[tap];
+            }
+        }
+        destination[i] = sum;
+    }
+}
+
+const float* SamplePlaybackKernel::getSincTable()
+{
+    //one row of sincNumTaps coefficients per fractional phase. calculated once and shared by all voices.
+    static const std::vector<float> sincTable = []()
+    {
+        std::vector<float> table(static_cast<size_t>(sincNumPhases * sincNumTaps));
+        const int halfTaps = sincNumTaps / 2;
+
+        for (int phase = 0; phase < sincNumPhases; ++phase)
+        {
+            double frac = static_cast<double>(phase) / static_cast<double>(sincNumPhases);
+            double sum = 0.0;
+
+            for (int tap = 0; tap < sincNumTaps; ++tap)
+            {
+                double x = static_cast<double>(tap - (halfTaps - 1)) - frac; //distance of the tap from the read position
+                double sinc = (x == 0.0) ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                double windowPos = (x + static_cast<double>(halfTaps)) / static_cast<double>(sincNumTaps); //[0,1]
+                double window = 0.42 - 0.5 * std::cos(2.0 * juce::MathConstants<double>::pi * windowPos) + 0.08 * std::cos(4.0 * juce::MathConstants<double>::pi * windowPos); //Blackman
+
+                table[static_cast<size_t>(phase * sincNumTaps + tap)] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+
+            //normalise the gain of each phase to 1 (otherwise, the windowing would cause slight amplitude ripple)
+            for (int tap = 0; tap < sincNumTaps; ++tap)
+            {
+                table[static_cast<size_t>(phase * sincNumTaps + tap)] /= static_cast<float>(sum);
+            }
+        }
+
+        return table;
+    }();
+
+    return sincTable.data();
+}
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    SamplePlaybackKernel.h
+    Created: 17 Oct 2026 10:14:03am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "InterpolationMethod.h"
+
+/// <summary>
+/// Reads whole blocks of samples from a sample buffer at precomputed (fractional) read positions.
+/// The read positions must lie within [0, numSourceSamples - 1). Since the last sample of a buffer is treated as being equal to the first,
+/// neighbouring samples that are needed for the interpolation wrap around at numSourceSamples - 1.
+/// </summary>
+class SamplePlaybackKernel
+{
+public:
+    typedef void(*interpolationFuncPt)(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples);
+
+    static interpolationFuncPt getInterpolationFunction(InterpolationMethod method);
+
+    static void readTruncated(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples);
+    static void readLinear(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples);
+    static void readCubic(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples);
+    static void readWindowedSinc(const float* source, int numSourceSamples, const double* readPositions, float* destination, int numSamples);
+
+    static const int sincNumTaps = 8;
+    static const int sincNumPhases = 512;
+
+private:
+    static const float* getSincTable();
+
+    static inline int wrapIndex(int index, int wrapLength)
+    {
+        //the indices are at most a few samples out of range, so this is much cheaper than a modulo
+        while (index < 0)
+            index += wrapLength;
+        while (index >= wrapLength)
+            index -= wrapLength;
+        return index;
+    }
+};
@@ -0,0 +1,536 @@
+/*
+  ==============================================================================
+
+    SampleStore.cpp
+    Created: 17 Oct 2026 6:21:40pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "SampleStore.h"
+
+//constants
+const int SampleStore::resamplingHalfTaps = 16;
+const int SampleStore::resamplingPhasesPerSample = 256;
+const double SampleStore::resamplingBandwidth = 0.95;
+const int SampleStore::mipMapHalfTaps = 16;
+const int SampleStore::maxMipLevels = 6;
+const int SampleStore::minMipLevelLength = 64;
+
+
+SampleStore::Sample::Sample(juce::AudioSampleBuffer& buffer, double sampleRate, juce::uint64 hash) :
+    sampleRate(sampleRate),
+    hash(hash)
+{
+    std::swap(this->buffer, buffer); //takes over the buffer's memory instead of copying it
+}
+
+const juce::AudioSampleBuffer& SampleStore::Sample::getBuffer() const
+{
+    return buffer;
+}
+double SampleStore::Sample::getSampleRate() const
+{
+    return sampleRate;
+}
+int SampleStore::Sample::getNumSamples() const
+{
+    return buffer.getNumSamples();
+}
+int SampleStore::Sample::getNumChannels() const
+{
+    return buffer.getNumChannels();
+}
+juce::uint64 SampleStore::Sample::getHash() const
+{
+    return hash;
+}
+SampleStore::MipMap::Ptr SampleStore::Sample::getMipMap() const
+{
+    return mipMap;
+}
+
+
+
+
+SampleStore::MipMap::MipMap(juce::OwnedArray<juce::AudioSampleBuffer>& levels)
+{
+    this->levels.swapWith(levels);
+}
+
+int SampleStore::MipMap::getNumLevels() const
+{
+    return levels.size();
+}
+const juce::AudioSampleBuffer& SampleStore::MipMap::getLevel(int level) const
+{
+    jassert(level >= 1 && level <= levels.size());
+    return *levels.getUnchecked(level - 1);
+}
+
+
+
+
+SampleStore::SampleStore() :
+    preparationPool(1)
+{ }
+SampleStore::~SampleStore()
+{
+    DBG("destroying SampleStore...");
+
+    preparationPool.removeAllJobs(true, 5000); //interrupts all jobs and waits for them to exit
+
+    deserialisedSamples.clear();
+    samples.clear(); //samples that are still used by regions or voices stay alive until those release them
+
+    DBG("SampleStore destroyed.");
+}
+
+void SampleStore::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+void SampleStore::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+SampleStore::Sample::Ptr SampleStore::add(juce::AudioSampleBuffer& buffer, double sampleRate)
+{
+    if (buffer.getNumSamples() == 0 || buffer.getNumChannels() == 0)
+    {
+        return nullptr;
+    }
+
+    releaseUnused();
+
+    juce::uint64 hash = calculateHash(buffer, sampleRate);
+    for (auto* sample : samples)
+    {
+        if (sample->hash == hash && sample->sampleRate == sampleRate && isEqual(sample->buffer, buffer))
+        {
+            DBG("sample already stored (hash: " + juce::String::toHexString(static_cast<juce::int64>(hash)) + ").");
+            return sample;
+        }
+    }
+
+    Sample::Ptr newSample = new Sample(buffer, sampleRate, hash);
+    samples.add(newSample);
+    startPreparing(newSample.get());
+
+    DBG("sample stored (hash: " + juce::String::toHexString(static_cast<juce::int64>(hash)) + "). number of stored samples: " + juce::String(samples.size()));
+    return newSample;
+}
+int SampleStore::getNumStoredSamples()
+{
+    return samples.size();
+}
+
+void SampleStore::setTargetSampleRate(double newTargetSampleRate)
+{
+    if (newTargetSampleRate == targetSampleRate)
+    {
+        return;
+    }
+    targetSampleRate = newTargetSampleRate;
+    DBG("target sample rate of the SampleStore: " + juce::String(targetSampleRate));
+
+    //copies at the previous rate aren't needed anymore (voices that still use them keep them alive until they're given the new copies)
+    preparationPool.removeAllJobs(true, 0);
+    for (auto* sample : samples)
+    {
+        sample->resampledCopy = nullptr;
+        sample->preparedRate = 0.0;
+        startPreparing(sample);
+    }
+}
+SampleStore::Sample::Ptr SampleStore::getPlayableSample(Sample::Ptr sample)
+{
+    if (sample == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (sample->resampledCopy != nullptr && sample->preparedRate == targetSampleRate)
+    {
+        return sample->resampledCopy;
+    }
+
+    startPreparing(sample.get()); //does nothing if the sample has already been prepared or is being prepared right now
+    return sample;
+}
+
+void SampleStore::startPreparing(Sample* sample)
+{
+    if (targetSampleRate <= 0.0 || sample->sampleRate <= 0.0 || sample->preparedRate == targetSampleRate)
+    {
+        return; //engine not prepared yet, or already prepared/preparing
+    }
+
+    sample->preparedRate = targetSampleRate;
+    if (sample->sampleRate == targetSampleRate && sample->mipMap != nullptr)
+    {
+        //neither resampling nor a new mip-map necessary (the mip-map doesn't depend on the engine's rate).
+        //voices may still be playing a copy that had been resampled to a previous rate though -> switch them back to the original
+        Sample::Ptr original = sample;
+        listeners.call([&original](Listener& l) { l.playableSampleReady(original, original); });
+        return;
+    }
+
+    preparationPool.addJob(new PreparePlaybackJob(*this, sample, targetSampleRate), true); //the pool deletes the job once it's finished
+}
+void SampleStore::preparationFinished(Sample::Ptr original, double rate, juce::AudioSampleBuffer& resampledBuffer, juce::OwnedArray<juce::AudioSampleBuffer>& mipLevels)
+{
+    if (rate != targetSampleRate || original->preparedRate != rate)
+    {
+        return; //outdated
+    }
+
+    Sample::Ptr playable = original;
+    if (resampledBuffer.getNumSamples() > 0)
+    {
+        original->resampledCopy = new Sample(resampledBuffer, rate, original->hash);
+        playable = original->resampledCopy;
+        DBG("sample has been resampled from " + juce::String(original->sampleRate) + " to " + juce::String(rate) + " (hash: " + juce::String::toHexString(static_cast<juce::int64>(original->hash)) + ").");
+    }
+    playable->mipMap = new MipMap(mipLevels);
+
+    listeners.call([&original, &playable](Listener& l) { l.playableSampleReady(original, playable); });
+}
+
+void SampleStore::beginSerialisation()
+{
+    for (auto* sample : samples)
+    {
+        sample->serialisedIndex = -1;
+    }
+}
+int SampleStore::serialise(Sample::Ptr sample, juce::Array<juce::MemoryBlock>* attachedData)
+{
+    if (sample == nullptr)
+    {
+        return -1; //nothing to serialise
+    }
+    if (sample->serialisedIndex >= 0)
+    {
+        return sample->serialisedIndex; //already serialised for another region
+    }
+
+    const juce::AudioSampleBuffer& buffer = sample->buffer;
+    int numChannels = buffer.getNumChannels();
+    int numSamples = buffer.getNumSamples();
+    size_t bufferMemorySize = static_cast<size_t>(numChannels * numSamples) * sizeof(float);
+
+    juce::MemoryBlock bufferMemory(bufferMemorySize);
+    juce::MemoryOutputStream bufferStream(bufferMemory, false); //by using this stream, the samples can be written in a certain endian (unlike memBuffer.append()), ensuring portability. little endian will be used.
+
+    //prepend size and number of the channels so that they can be read correctly
+    bufferStream.writeInt(numChannels);
+    bufferStream.writeInt(numSamples);
+    bufferStream.flush();
+
+    //copy the content of the buffer - unfortunately, the channels can't be written as a whole, so it has to be done sample-by-sample...
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* channelSamples = buffer.getReadPointer(ch);
+
+        for (int s = 0; s < numSamples; ++s)
+        {
+            bufferStream.writeFloat(channelSamples[s]);
+        }
+        bufferStream.flush();
+    }
+
+    attachedData->add(bufferMemory);
+    sample->serialisedIndex = attachedData->size() - 1;
+    return sample->serialisedIndex;
+}
+void SampleStore::beginDeserialisation()
+{
+    deserialisedSamples.clear();
+}
+SampleStore::Sample::Ptr SampleStore::deserialise(int index, double sampleRate, juce::Array<juce::MemoryBlock>* attachedData)
+{
+    if (index < 0 || index >= attachedData->size())
+    {
+        return nullptr;
+    }
+    if (deserialisedSamples.contains(index))
+    {
+        return deserialisedSamples[index]; //shared with another region
+    }
+
+    juce::MemoryBlock bufferMemory = (*attachedData)[index];
+    juce::MemoryInputStream bufferStream(bufferMemory, false); //by using this stream, the samples can be read in a certain endian, ensuring portability. little endian will be used.
+
+    //get the size and number of the channels so that they can be read correctly
+    int numChannels = bufferStream.readInt();
+    int numSamples = bufferStream.readInt();
+    juce::AudioSampleBuffer tempBuffer(numChannels, numSamples);
+
+    //copy the content of the buffer - unfortunately, the channels can't be written as a whole, so it has to be done sample-by-sample...
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* channelSamples = tempBuffer.getWritePointer(ch);
+
+        for (int s = 0; s < numSamples; ++s)
+        {
+            channelSamples[s] = bufferStream.readFloat();
+        }
+    }
+
+    auto sample = add(tempBuffer, sampleRate); //presets from older versions contain one copy per region, which are merged here
+    deserialisedSamples.set(index, sample);
+    return sample;
+}
+void SampleStore::endDeserialisation()
+{
+    deserialisedSamples.clear();
+    releaseUnused();
+}
+
+juce::uint64 SampleStore::calculateHash(const juce::AudioSampleBuffer& buffer, double sampleRate)
+{
+    //FNV-1a over the raw sample data. collisions are harmless, because the content is compared as well when the hashes are equal
+    const juce::uint64 prime = 0x100000001b3ULL;
+    juce::uint64 hash = 0xcbf29ce484222325ULL;
+
+    auto combine = [&hash, prime](juce::uint32 value)
+    {
+        hash ^= value;
+        hash *= prime;
+    };
+
+    combine(static_cast<juce::uint32>(buffer.getNumChannels()));
+    combine(static_cast<juce::uint32>(buffer.getNumSamples()));
+    combine(static_cast<juce::uint32>(juce::roundToInt(sampleRate)));
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        auto* channelSamples = buffer.getReadPointer(ch);
+        for (int s = 0; s < buffer.getNumSamples(); ++s)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, channelSamples + s, sizeof(bits));
+            combine(bits);
+        }
+    }
+
+    return hash;
+}
+bool SampleStore::isEqual(const juce::AudioSampleBuffer& a, const juce::AudioSampleBuffer& b)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+    {
+        return false;
+    }
+
+    for (int ch = 0; ch < a.getNumChannels(); ++ch)
+    {
+        if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch), static_cast<size_t>(a.getNumSamples()) * sizeof(float)) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+void SampleStore::releaseUnused()
+{
+    //samples that are only referenced by the store itself aren't used by any region or voice anymore
+    for (int i = samples.size() - 1; i >= 0; --i)
+    {
+        if (samples.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+        {
+            samples.remove(i);
+        }
+    }
+}
+
+
+
+
+SampleStore::PreparePlaybackJob::PreparePlaybackJob(SampleStore& owner, Sample::Ptr original, double targetSampleRate) :
+    juce::ThreadPoolJob("Prepare sample for " + juce::String(targetSampleRate)),
+    owner(&owner),
+    original(original),
+    targetSampleRate(targetSampleRate)
+{ }
+
+juce::ThreadPoolJob::JobStatus SampleStore::PreparePlaybackJob::runJob()
+{
+    auto resampledBuffer = std::make_shared<juce::AudioSampleBuffer>(); //stays empty if no resampling is necessary
+    if (original->sampleRate != targetSampleRate && !resample(original->buffer, original->sampleRate, *resampledBuffer))
+    {
+        return juce::ThreadPoolJob::jobHasFinished; //interrupted -> no callback
+    }
+
+    auto mipLevels = std::make_shared<juce::OwnedArray<juce::AudioSampleBuffer>>();
+    if (!buildMipLevels(resampledBuffer->getNumSamples() > 0 ? *resampledBuffer : original->buffer, *mipLevels))
+    {
+        return juce::ThreadPoolJob::jobHasFinished; //interrupted -> no callback
+    }
+
+    auto weakOwner = owner;
+    auto sample = original;
+    auto rate = targetSampleRate;
+    juce::MessageManager::callAsync([weakOwner, sample, rate, resampledBuffer, mipLevels]
+        {
+            if (weakOwner != nullptr)
+            {
+                weakOwner->preparationFinished(sample, rate, *resampledBuffer, *mipLevels);
+            }
+        });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+bool SampleStore::PreparePlaybackJob::resample(const juce::AudioSampleBuffer& source, double sourceRate, juce::AudioSampleBuffer& destination)
+{
+    //polyphase windowed-sinc interpolation. the sinc's cutoff lies slightly below the lower of the two Nyquist frequencies,
+    //so downsampling doesn't alias. in that case, the sinc is stretched accordingly (-> more taps).
+    //like during playback, the last sample is treated as being equal to the first, i.e. neighbouring samples wrap around at numSourceSamples - 1.
+    const int numSourceSamples = source.getNumSamples();
+    const int wrapLength = juce::jmax(1, numSourceSamples - 1);
+    const double step = sourceRate / targetSampleRate; //distance between two output samples in source samples
+    const double cutoff = resamplingBandwidth * juce::jmin(1.0, 1.0 / step); //relative to the source's Nyquist frequency
+    const double halfWidth = static_cast<double>(resamplingHalfTaps) / cutoff; //in source samples
+    const int numTapsEachSide = static_cast<int>(std::ceil(halfWidth));
+
+    //filter table: cutoff * sinc(cutoff * x) * blackman(x), sampled at resamplingPhasesPerSample points per source sample within [-halfWidth, halfWidth]
+    const int tableSize = static_cast<int>(std::ceil(2.0 * halfWidth * resamplingPhasesPerSample)) + 2;
+    juce::HeapBlock<float> table(tableSize, true);
+    for (int i = 0; i < tableSize; ++i)
+    {
+        double x = static_cast<double>(i) / resamplingPhasesPerSample - halfWidth;
+        if (std::abs(x) >= halfWidth)
+        {
+            continue; //outside of the window -> 0
+        }
+
+        double sincArg = juce::MathConstants<double>::pi * cutoff * x;
+        double sinc = (sincArg == 0.0) ? 1.0 : std::sin(sincArg) / sincArg;
+        double windowPos = (x + halfWidth) / (2.0 * halfWidth); //within [0,1]
+        double window = 0.42 - 0.5 * std::cos(2.0 * juce::MathConstants<double>::pi * windowPos) + 0.08 * std::cos(4.0 * juce::MathConstants<double>::pi * windowPos);
+        table[i] = static_cast<float>(cutoff * sinc * window);
+    }
+
+    const int numDestinationSamples = juce::jmax(1, static_cast<int>(std::round(static_cast<double>(wrapLength) / step)) + 1);
+    destination.setSize(source.getNumChannels(), numDestinationSamples);
+
+    const int checkInterval = 4096; //number of output samples between two checks for interruption
+    for (int ch = 0; ch < source.getNumChannels(); ++ch)
+    {
+        const float* input = source.getReadPointer(ch);
+        float* output = destination.getWritePointer(ch);
+
+        for (int n = 0; n < numDestinationSamples; ++n)
+        {
+            if (n % checkInterval == 0 && shouldExit())
+            {
+                return false;
+            }
+
+            double t = static_cast<double>(n) * step;
+            int centre = static_cast<int>(t);
+            double sum = 0.0;
+
+            for (int k = centre - numTapsEachSide + 1; k <= centre + numTapsEachSide; ++k)
+            {
+                double tablePos = (static_cast<double>(k) - t + halfWidth) * resamplingPhasesPerSample;
+                int tableIndex = static_cast<int>(tablePos);
+                if (tableIndex < 0 || tableIndex >= tableSize - 1)
+                {
+                    continue;
+                }
+                float frac = static_cast<float>(tablePos - tableIndex);
+                float coefficient = table[tableIndex] + frac * (table[tableIndex + 1] - table[tableIndex]); //linear interpolation between neighbouring phases
+
+                int index = k % wrapLength;
+                if (index < 0)
+                {
+                    index += wrapLength;
+                }
+                sum += input[index] * coefficient;
+            }
+
+            output[n] = static_cast<float>(sum);
+        }
+    }
+
+    return true;
+}
+
+bool SampleStore::PreparePlaybackJob::buildMipLevels(const juce::AudioSampleBuffer& source, juce::OwnedArray<juce::AudioSampleBuffer>& levels)
+{
+    //every level is the previous one low-pass filtered at half its Nyquist frequency (windowed sinc) and decimated by 2.
+    //the filter is only evaluated at the retained samples.
+    const int numTaps = 2 * mipMapHalfTaps + 1;
+    juce::HeapBlock<float> coefficients(numTaps);
+    for (int i = 0; i < numTaps; ++i)
+    {
+        double x = static_cast<double>(i - mipMapHalfTaps);
+        double sincArg = juce::MathConstants<double>::pi * 0.5 * x;
+        double sinc = (sincArg == 0.0) ? 1.0 : std::sin(sincArg) / sincArg;
+        double windowPos = static_cast<double>(i) / static_cast<double>(numTaps - 1);
+        double window = 0.42 - 0.5 * std::cos(2.0 * juce::MathConstants<double>::pi * windowPos) + 0.08 * std::cos(4.0 * juce::MathConstants<double>::pi * windowPos);
+        coefficients[i] = static_cast<float>(0.5 * sinc * window);
+    }
+
+    const juce::AudioSampleBuffer* previous = &source;
+    while (levels.size() < maxMipLevels)
+    {
+        //like during playback, the last sample is treated as being equal to the first -> wrap at numSamples - 1
+        int previousWrapLength = previous->getNumSamples() - 1;
+        int wrapLength = previousWrapLength / 2;
+        if (wrapLength < minMipLevelLength)
+        {
+            break;
+        }
+
+        auto* level = levels.add(new juce::AudioSampleBuffer(previous->getNumChannels(), wrapLength + 1));
+        for (int ch = 0; ch < previous->getNumChannels(); ++ch)
+        {
+            if (shouldExit())
+            {
+                return false;
+            }
+
+            const float* input = previous->getReadPointer(ch);
+            float* output = level->getWritePointer(ch);
+
+            for (int m = 0; m < wrapLength; ++m)
+            {
+                int centre = 2 * m;
+                float sum = 0.0f;
+                if (centre >= mipMapHalfTaps && centre + mipMapHalfTaps < previousWrapLength)
+                {
+                    //no wrapping required (by far the most common case)
+                    for (int i = 0; i < numTaps; ++i)
+                    {
+                        sum += input[centre - mipMapHalfTaps + i] * coefficients[i];
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < numTaps; ++i)
+                    {
+                        int index = (centre - mipMapHalfTaps + i) % previousWrapLength;
+                        if (index < 0)
+                        {
+                            index += previousWrapLength;
+                        }
+                        sum += input[index] * coefficients[i];
+                    }
+                }
+                output[m] = sum;
+            }
+            output[wrapLength] = output[0];
+        }
+
+        previous = level;
+    }
+
+    return true;
+}
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    SampleStore.h
+    Created: 17 Oct 2026 6:21:40pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/// <summary>
+/// Keeps every sample (decoded audio file) in memory exactly once, no matter how many regions and voices use it.
+/// Samples are immutable and reference-counted: regions and voices only hold handles (Sample::Ptr) to them.
+/// Identical samples are recognised by a hash of their content, so loading the same file into several regions or restoring a preset in which
+/// several regions share a file doesn't store the sample more than once. Samples are also serialised only once per preset.
+/// Samples are prepared for playback on a background thread: if their sample rate differs from the engine's, they are resampled to the engine's rate (polyphase windowed sinc),
+/// and a mip-map of band-limited octave copies is built, so that voices can play them at high speeds without aliasing.
+/// The prepared (playable) version is cached within the original sample and rebuilt whenever the engine's sample rate changes. Listeners are notified once it's ready.
+/// All methods must only be called from the message thread.
+/// </summary>
+class SampleStore
+{
+public:
+    /// <summary>
+    /// Band-limited copies of a sample, each one octave lower than the previous one (i.e. with half as many samples).
+    /// Level 0 is the sample itself and thus isn't contained here. Level n has a length of ((numSamples - 1) >> n) + 1, so that its wrap length is exactly halved per level.
+    /// </summary>
+    class MipMap : public juce::ReferenceCountedObject
+    {
+    public:
+        using Ptr = juce::ReferenceCountedObjectPtr<MipMap>;
+
+        MipMap(juce::OwnedArray<juce::AudioSampleBuffer>& levels); //takes over the levels (levels is empty afterwards)
+
+        int getNumLevels() const; //excluding level 0
+        const juce::AudioSampleBuffer& getLevel(int level) const; //level within [1, getNumLevels()]
+
+    private:
+        juce::OwnedArray<juce::AudioSampleBuffer> levels;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MipMap)
+    };
+
+    class Sample : public juce::ReferenceCountedObject
+    {
+    public:
+        using Ptr = juce::ReferenceCountedObjectPtr<Sample>;
+
+        const juce::AudioSampleBuffer& getBuffer() const;
+        double getSampleRate() const;
+        int getNumSamples() const;
+        int getNumChannels() const;
+        juce::uint64 getHash() const; //resampled copies have the same hash as their original
+        MipMap::Ptr getMipMap() const; //nullptr if it hasn't been built (yet). must only be called from the message thread
+
+    private:
+        friend class SampleStore;
+        Sample(juce::AudioSampleBuffer& buffer, double sampleRate, juce::uint64 hash);
+
+        juce::AudioSampleBuffer buffer;
+        double sampleRate;
+        juce::uint64 hash;
+        int serialisedIndex = -1; //index within attachedData during serialisation (-1 if not serialised yet)
+
+        MipMap::Ptr mipMap;
+        Ptr resampledCopy; //copy at preparedRate, or nullptr if it isn't ready (yet) or isn't needed
+        double preparedRate = 0.0; //rate that this sample has been (or is currently being) prepared for (0.0 if none)
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sample)
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /// <summary>
+        /// Called (on the message thread) when a sample has been prepared for playback.
+        /// </summary>
+        /// <param name="playable">The original's resampled copy, or the original itself (which now has a mip-map) if it didn't need to be resampled</param>
+        virtual void playableSampleReady(Sample::Ptr original, Sample::Ptr playable) = 0;
+    };
+
+    SampleStore();
+    ~SampleStore();
+
+    void addListener(Listener* listener);
+    void removeListener(Listener* listener);
+
+    /// <summary>
+    /// Returns the stored sample with the same content, or stores a new one. In the latter case, the content of buffer is moved into the store (buffer is empty afterwards).
+    /// </summary>
+    /// <returns>Handle to the sample, or nullptr if buffer is empty</returns>
+    Sample::Ptr add(juce::AudioSampleBuffer& buffer, double sampleRate);
+    int getNumStoredSamples();
+
+    /// <summary>
+    /// Sets the rate that all samples should be played back at (the engine's sample rate). Starts preparing all stored samples for the new rate.
+    /// </summary>
+    void setTargetSampleRate(double newTargetSampleRate);
+    /// <summary>
+    /// Returns the version of the given sample that should be played back: its resampled copy if that's ready, or the sample itself otherwise
+    /// (in which case it is prepared in the background, if necessary, and the listeners will be notified once it's ready).
+    /// </summary>
+    Sample::Ptr getPlayableSample(Sample::Ptr sample);
+
+    //serialisation: every sample is only written into attachedData once per preset. beginSerialisation/beginDeserialisation must be called before the first sample is (de)serialised.
+    void beginSerialisation();
+    int serialise(Sample::Ptr sample, juce::Array<juce::MemoryBlock>* attachedData); //returns the index of the sample's data within attachedData
+    void beginDeserialisation();
+    Sample::Ptr deserialise(int index, double sampleRate, juce::Array<juce::MemoryBlock>* attachedData); //returns nullptr if index doesn't contain a sample
+    void endDeserialisation();
+
+private:
+    class PreparePlaybackJob : public juce::ThreadPoolJob
+    {
+    public:
+        PreparePlaybackJob(SampleStore& owner, Sample::Ptr original, double targetSampleRate);
+
+        juce::ThreadPoolJob::JobStatus runJob() override;
+
+    private:
+        juce::WeakReference<SampleStore> owner;
+        Sample::Ptr original;
+        double targetSampleRate;
+
+        bool resample(const juce::AudioSampleBuffer& source, double sourceRate, juce::AudioSampleBuffer& destination); //returns false if the job has been interrupted
+        bool buildMipLevels(const juce::AudioSampleBuffer& source, juce::OwnedArray<juce::AudioSampleBuffer>& levels); //returns false if the job has been interrupted
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreparePlaybackJob)
+    };
+
+    juce::ReferenceCountedArray<Sample> samples;
+    juce::HashMap<int, Sample::Ptr> deserialisedSamples; //index within attachedData -> sample. only filled during deserialisation
+
+    juce::ListenerList<Listener> listeners;
+    double targetSampleRate = 0.0; //0.0 while the engine hasn't been prepared yet -> no resampling
+    juce::ThreadPool preparationPool;
+
+    void startPreparing(Sample* sample);
+    void preparationFinished(Sample::Ptr original, double rate, juce::AudioSampleBuffer& resampledBuffer, juce::OwnedArray<juce::AudioSampleBuffer>& mipLevels);
+
+    static const int resamplingHalfTaps; //number of zero crossings of the sinc on either side (at the source's rate when upsampling)
+    static const int resamplingPhasesPerSample; //resolution of the polyphase table
+    static const double resamplingBandwidth; //cutoff frequency relative to the lower of the two Nyquist frequencies
+    static const int mipMapHalfTaps; //half length of the decimation filter
+    static const int maxMipLevels; //the pitch range (+60 semitones) spans 5 octaves
+    static const int minMipLevelLength; //levels aren't shortened any further than this
+
+    static juce::uint64 calculateHash(const juce::AudioSampleBuffer& buffer, double sampleRate);
+    static bool isEqual(const juce::AudioSampleBuffer& a, const juce::AudioSampleBuffer& b);
+    void releaseUnused();
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(SampleStore)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStore)
+};
@@ -11,6 +11,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SampleStore.h"
+#include "StreamingAudioFile.h"
 
 //==============================================================================
 /*
@@ -18,22 +20,44 @@
 struct SamplerOscillator  : public juce::SynthesiserSound //WIP: make this a SamplerSound later. SamplerSound has a lot more useful methods and parameters
 {
 public:
-    SamplerOscillator(juce::AudioBuffer<float> fileBuffer, double origSampleRate)
+    using Ptr = juce::ReferenceCountedObjectPtr<SamplerOscillator>; //instances are immutable snapshots that are handed to the audio thread via a SnapshotExchange
+
+    SamplerOscillator(SampleStore::Sample::Ptr sample)
+    {
+        this->sample = sample;
+        this->mipMap = (sample != nullptr) ? sample->getMipMap() : nullptr; //snapshot of the mip-map at this point (it may still be built later on)
+        this->origSampleRate = (sample != nullptr) ? sample->getSampleRate() : 0.0;
+    }
+
+    SamplerOscillator(StreamingAudioFile::Ptr stream)
     {
-        this->fileBuffer = fileBuffer;
-        this->origSampleRate = origSampleRate;
+        this->stream = stream;
+        this->origSampleRate = stream->getSampleRate();
     }
 
     ~SamplerOscillator() override
+    { }
+
+    int getNumSamples()
+    {
+        if (stream != nullptr)
+            return stream->getNumSamples();
+        return (sample != nullptr) ? sample->getNumSamples() : 0;
+    }
+    int getNumChannels()
     {
-        fileBuffer.clear();
+        if (stream != nullptr)
+            return stream->getNumChannels();
+        return (sample != nullptr) ? sample->getNumChannels() : 0;
     }
 
 
     bool appliesToNote(int) override { return false; }
     bool appliesToChannel(int) override { return false; }
 
-    juce::AudioBuffer<float> fileBuffer;
+    SampleStore::Sample::Ptr sample; //shared with the region and all its other voices. nullptr if the file is streamed or if there is no file
+    SampleStore::MipMap::Ptr mipMap; //band-limited octave copies of sample for high playback speeds. nullptr if they haven't been built (yet)
+    StreamingAudioFile::Ptr stream; //nullptr if the file is kept in memory
     double origSampleRate;
     //double sampleRateConversionMultiplier;
 
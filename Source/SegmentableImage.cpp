@@ -697,6 +697,7 @@ void SegmentableImage::clearPlayPaths()
     {
         removeChildComponent(*itPath);
         audioEngine->removeMidiListener(*itPath);
+        audioEngine->removePlayPath(*itPath);
     }
     playPaths.clear(true);
     playPathIdCounter = -1;
@@ -717,6 +718,7 @@ void SegmentableImage::removePlayPath(int pathID)
             //path found -> remove
             removeChildComponent(*itPath);
             audioEngine->removeMidiListener(*itPath);
+            audioEngine->removePlayPath(*itPath);
             playPaths.remove(i);
             break; //IDs are unique
         }
@@ -1181,6 +1183,7 @@ void SegmentableImage::addPlayPath(PlayPath* newPlayPath)
 {
     playPaths.add(newPlayPath);
     audioEngine->addMidiListener(newPlayPath);
+    audioEngine->addPlayPath(newPlayPath);
 
     newPlayPath->setAlwaysOnTop(true);
     switch (currentStateIndex)
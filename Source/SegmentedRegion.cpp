@@ -31,6 +31,7 @@ SegmentedRegion::SegmentedRegion(const juce::Path& outline, const juce::Rectangl
 
     this->audioEngine = audioEngine;
     ID = audioEngine->addNewRegion(fillColour, this); //also generates the region's LFO and all its Voice instances.
+    audioEngine->getSampleStore()->addListener(this);
     associatedLfo = audioEngine->getLfo(ID);
     associatedVoices = audioEngine->getVoicesWithID(ID);
 
@@ -55,9 +56,10 @@ SegmentedRegion::SegmentedRegion(const juce::Path& outline, const juce::Rectangl
     focus.setXY(focus.getX() / p.getBounds().getWidth(), focus.getY() / p.getBounds().getHeight()); //relative centre
 
     //LFO
+    outlineTable.rebuild(p);
     renderLfoWaveform(); //initialises LFO further (generates its wavetable)
 
-    setBuffer(juce::AudioSampleBuffer(), "", 0.0); //no audio file set yet -> empty buffer
+    setSample(nullptr, ""); //no audio file set yet
     
     setBufferedToImage(true);
     setPaintingIsUnclipped(true);
@@ -72,6 +74,7 @@ SegmentedRegion::~SegmentedRegion()
     DBG("destroying SegmentedRegion...");
 
     stopTimer();
+    cancelPendingUpdate();
 
     if (regionEditorWindow != nullptr)
     {
@@ -87,6 +90,8 @@ SegmentedRegion::~SegmentedRegion()
     int deletedStates = 3;
     jassert(deletedStates == static_cast<int>(SegmentedRegionStateIndex::StateIndexCount));
 
+    audioEngine->getSampleStore()->removeListener(this);
+
     //release LFO
     associatedLfo = nullptr;
     audioEngine->removeLfo(getID()); //exception freeing heap after the LFO has been destroyed -> some invalid member?
@@ -201,7 +206,7 @@ void SegmentedRegion::timerCallback()
     //update currentLfoLine
     //float curLfoPhase = associatedLfo->getLatestModulatedPhase(); //basically the same value as getModulatedValue of the parameter, but won't update that parameter (which would mess with the modulation)
     float curLfoPhase = associatedLfo->getPhase(); //basically the same value as getModulatedValue of the parameter, but won't update that parameter (which would mess with the modulation)
-    juce::Point<float> outlinePt = p.getPointAlongPath(curLfoPhase * p.getLength(), juce::AffineTransform(), juce::Path::defaultToleranceForMeasurement);
+    juce::Point<float> outlinePt = outlineTable.getPointAlongPath(curLfoPhase * outlineTable.getLength());
     currentLfoLine = juce::Line<float>(focusAbs.x, focusAbs.y,
                                        outlinePt.x, outlinePt.y);
 
@@ -298,6 +303,8 @@ void SegmentedRegion::resized() //WIP: for some reason, this is called when hove
 {
     //recalculate hitbox
     p.scaleToFit(0.0f, 0.0f, (float)getWidth(), (float)getHeight(), false);
+    outlineTable.rebuild(p);
+    hitMask.rebuild(p, getWidth(), getHeight());
 
     //update (actual) focus point position
     focusAbs = juce::Point<float>(focus.x * getBounds().getWidth(),
@@ -315,7 +322,7 @@ bool SegmentedRegion::hitTest(int x, int y)
 }
 bool SegmentedRegion::hitTest_Interactable(int x, int y)
 {
-    return p.contains((float)x, (float)y);
+    return hitMask.contains(x, y); //constant time, unlike p.contains
 }
 
 juce::String SegmentedRegion::getTooltip()
@@ -428,14 +435,14 @@ void SegmentedRegion::clicked(const juce::ModifierKeys& modifiers)
     }
 }
 
-void SegmentedRegion::setBuffer(juce::AudioSampleBuffer newBuffer, juce::String fileName, double origSampleRate)
+void SegmentedRegion::setSample(SampleStore::Sample::Ptr newSample, juce::String fileName)
 {
-    buffer = newBuffer;
-    audioFileName = fileName;
-    this->origSampleRate = origSampleRate;
+    sample = newSample;
+    stream = nullptr;
+    audioFileName = (newSample != nullptr) ? fileName : "";
+    origSampleRate = (newSample != nullptr) ? newSample->getSampleRate() : 0.0;
 
-    bool wasSuspended = audioEngine->isSuspended();
-    audioEngine->suspendProcessing(true);
+    //the voices build their new oscillators here and the audio thread swaps them in at its next block boundary, so the engine keeps running
     if (audioFileName != "")
     {
         if (associatedVoices.size() == 0)
@@ -443,77 +450,75 @@ void SegmentedRegion::setBuffer(juce::AudioSampleBuffer newBuffer, juce::String
             audioEngine->initialiseVoicesForRegion(getID()); //may create more than 1 voice
             associatedVoices = audioEngine->getVoicesWithID(getID());
         }
-
-        //update buffers
-        for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
-        {
-            (*itVoice)->setOsc(newBuffer, origSampleRate); //update sampler file in every voice
-        }
     }
-    else
+
+    //update samples (or remove them if newSample is nullptr). until the sample has been prepared for playback (resampled to the engine's rate, mip-mapped),
+    //the voices play the original (see playableSampleReady)
+    auto playableSample = audioEngine->getSampleStore()->getPlayableSample(newSample);
+    for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
     {
-        //set to empty buffer
-        auto emptyBuffer = juce::AudioSampleBuffer();
-        for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
-        {
-            (*itVoice)->setOsc(emptyBuffer, 0);
-        }
+        (*itVoice)->setOsc(playableSample); //all voices share the same sample
     }
-    audioEngine->suspendProcessing(wasSuspended);
 
-    DBG("new buffer has been set. length: " + juce::String(origSampleRate > 0.0 ? static_cast<double>(buffer.getNumSamples()) / origSampleRate : 0.0) + " seconds.");
+    DBG("new sample has been set. length: " + juce::String(newSample != nullptr ? static_cast<double>(newSample->getNumSamples()) / origSampleRate : 0.0) + " seconds.");
 }
 
-void SegmentedRegion::renderLfoWaveform()
+void SegmentedRegion::playableSampleReady(SampleStore::Sample::Ptr original, SampleStore::Sample::Ptr playable)
 {
-    DBG("rendering LFO's waveform...");
+    if (original != sample)
+    {
+        return; //not this region's sample
+    }
 
-    juce::AudioBuffer<float> waveform(1, juce::jmax<int>(2, (int)p.getLength()) + 1); //minimum size of 2 samples (should always be the case since a minimum of 3 points are necessary to define a region)
-    auto samples = waveform.getWritePointer(0);
+    for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
+    {
+        (*itVoice)->setOsc(playable); //the voices keep their relative playback positions
+    }
+}
 
-    //the for-loop will iterate from 0.0 to the end point (length) of the path.
-    //to get the desired number of samples, the path must be divided into sections with the following distance:
-    float stepDistance = p.getLength() / ((float)(waveform.getNumSamples() - 2));
+void SegmentedRegion::setStream(StreamingAudioFile::Ptr newStream, juce::String fileName)
+{
+    sample = nullptr; //the file isn't kept in memory
+    stream = newStream;
+    audioFileName = fileName;
+    origSampleRate = newStream->getSampleRate();
 
-    juce::Point<float> relativeFocus(focus.getX() * getBounds().getWidth(), focus.getY() * getBounds().getHeight());
-    for (int i = 0; i < waveform.getNumSamples() - 1; ++i)
+    if (associatedVoices.size() == 0)
     {
-
-        samples[i] = p.getPointAlongPath((float)i * stepDistance, //this will usually just iterate between each pixel
-            juce::AffineTransform(), //no transform
-            juce::Path::defaultToleranceForMeasurement //?
-        ).getDistanceSquaredFrom(relativeFocus); //use distance from focus point to create a 1D value
+        audioEngine->initialiseVoicesForRegion(getID()); //may create more than 1 voice
+        associatedVoices = audioEngine->getVoicesWithID(getID());
     }
-    //the last sample will be set to the first one after normalisation (see there)
-
-    //normalise to -1...1 (can be set to 0...1 later via RegionLfo.setPolarity)
-    auto range = waveform.findMinMax(0, 0, waveform.getNumSamples() - 1);
-    //float mid = range.getStart() + range.getLength() * 0.5f;
-    //float mult = 1.0f / (range.getEnd() - mid); //= 1.0f / (mid - range.getStart()) = -1.0f / (range.getStart() - mid) //when normalising to -1...1
-    float mult = 1.0f / range.getLength(); //when normalising to 0...1
 
-    for (int i = 0; i < waveform.getNumSamples() - 1; ++i)
+    //update streams
+    for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
     {
-        //samples[i] = (samples[i] - mid) * mult; //when normalising to -1...1
-        samples[i] = (samples[i] - range.getStart()) * mult; //when normalising to 0...1
+        (*itVoice)->setOsc(newStream); //all voices share the same stream
     }
-    samples[waveform.getNumSamples() - 1] = waveform.getSample(0, 0); //the last sample is equal to the first -> makes wrapping simpler and faster
 
-    //apply to LFO
-    bool wasSuspended = audioEngine->isSuspended();
+    DBG("new stream has been set. length: " + juce::String(static_cast<double>(newStream->getNumSamples()) / origSampleRate) + " seconds.");
+}
+
+void SegmentedRegion::renderLfoWaveform()
+{
+    DBG("rendering LFO's waveform...");
+
+    //the table length depends on the outline's detail rather than its size (see OutlineWaveTableBuilder)
+    juce::AudioBuffer<float> waveform;
+    juce::Point<float> relativeFocus(focus.getX() * getBounds().getWidth(), focus.getY() * getBounds().getHeight());
+    waveTableBuilder.setMaxHarmonic(calculateLfoMaxHarmonic());
+    auto range = waveTableBuilder.build(outlineTable, relativeFocus, waveform); //normalised to 0...1 (converted to -1...1 by RegionLfo)
+    DBG("LFO wavetable length: " + juce::String(waveform.getNumSamples()));
+
+    //apply to LFO (without suspending the audio engine - see RegionLfo::setWaveTable and AudioEngine::addLfo)
     if (audioEngine->getLfo(ID) == nullptr) //lfo not yet initialised
     {
         associatedLfo = new RegionLfo(waveform, RegionLfo::Polarity::unipolar, getID()); //no modulation until the voice has been initialised
-        
-        audioEngine->suspendProcessing(true);
         audioEngine->addLfo(associatedLfo);
     }
     else
     {
-        audioEngine->suspendProcessing(true);
-        associatedLfo->setWaveTable(waveform, RegionLfo::Polarity::unipolar);
+        associatedLfo->setWaveTable(waveform, RegionLfo::Polarity::unipolar); //picked up by the audio thread at its next block boundary
     }
-    audioEngine->suspendProcessing(wasSuspended);
 
     //calculate new LFO depth
     float maxLength = std::sqrt(static_cast<float>(getParentWidth() * getParentWidth() + getParentHeight() * getParentHeight())); //diagonal of the image (-> longest line)
@@ -529,6 +534,35 @@ void SegmentedRegion::renderLfoWaveform()
     DBG("LFO's waveform has been rendered.");
 }
 
+void SegmentedRegion::lfoRateChanged()
+{
+    if (calculateLfoMaxHarmonic() != waveTableBuilder.getMaxHarmonic())
+    {
+        renderLfoWaveform();
+    }
+}
+int SegmentedRegion::calculateLfoMaxHarmonic()
+{
+    //the LFO is only evaluated once per update: at most once per control step of the AudioEngine, and less often if its update interval is longer than that.
+    //harmonics of the wavetable above half of that evaluation rate would alias
+    double sampleRate = audioEngine->getSampleRate();
+    if (associatedLfo == nullptr || sampleRate <= 0.0 || associatedLfo->getBaseFrequency() <= 0.0f)
+    {
+        return 0;
+    }
+
+    double controlRateChunkSize = static_cast<double>(audioEngine->getControlRateChunkSize());
+    double updateIntervalSamples = static_cast<double>(associatedLfo->getUpdateInterval_Milliseconds()) * 0.001 * sampleRate;
+    double samplesPerUpdate = juce::jmax(1.0, std::ceil(updateIntervalSamples / controlRateChunkSize)) * controlRateChunkSize; //updates happen at control step boundaries
+    double maxHarmonic = 0.5 * sampleRate / (samplesPerUpdate * static_cast<double>(associatedLfo->getBaseFrequency()));
+
+    if (maxHarmonic >= static_cast<double>(OutlineWaveTableBuilder::maxTableLength / 2))
+    {
+        return 0; //no band-limiting necessary: the table can't contain harmonics that high anyway
+    }
+    return juce::nextPowerOfTwo(juce::jmax(1, static_cast<int>(maxHarmonic)) + 1) / 2; //quantised to powers of two, so that the waveform isn't re-rendered whenever the rate changes slightly
+}
+
 int SegmentedRegion::getID()
 {
     return ID;
@@ -548,6 +582,11 @@ bool SegmentedRegion::tryChangeID(int newID)
     }
 }
 
+const juce::Path& SegmentedRegion::getOutline()
+{
+    return p;
+}
+
 juce::Point<float> SegmentedRegion::getFocusPoint()
 {
     return focus;
@@ -615,25 +654,22 @@ void SegmentedRegion::startPlaying(bool toggleButtonState)
         DBG("*plays region " + juce::String(ID) + "*");
         isPlaying = true;
         
-        //DBG("voice: " + juce::String(currentVoiceIndex + 1) + " / " + juce::String(associatedVoices.size()));
-
-        associatedVoices[currentVoiceIndex]->startNote(0, 1.0f, audioEngine->getSynth()->getSound(0).get(), 64); //cycle through all voices (incremented after this voice stops)
+        currentVoice = audioEngine->getVoicePool()->startVoice(ID, audioEngine->getSynth()->getSound(0).get()); //plays an idle voice of this region, or steals one
 
         //try to set the button's toggle state to "down" (needs to be done cross-thread for MIDI messages because they do not run on the same thread as couriers and clicks)
         if (toggleButtonState)
         {
             if (juce::MessageManager::getInstance()->isThisTheMessageThread())
             {
+                pendingToggleState.store(true); //in case an older asynchronous update is still pending
                 setToggleState(true, juce::NotificationType::dontSendNotification);
                 //setState(juce::Button::ButtonState::buttonDown);
             }
             else
             {
-                juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                    {
-                        static_cast<SegmentedRegion*>(data)->setToggleState(true, juce::NotificationType::dontSendNotification);
-                        return static_cast<void*>(nullptr);
-                    }, this);
+                //don't wait for the message thread: couriers and MIDI messages start and stop regions on the audio thread
+                pendingToggleState.store(true);
+                triggerAsyncUpdate();
             }
         }
 
@@ -649,8 +685,11 @@ void SegmentedRegion::stopPlaying(bool toggleButtonState)
     if (isPlaying && !shouldBePlaying()) //region is playing, but it was requested that it shouldn't do so anymore. (the audio file needn't be checked because the region cannot start playing without the file having been checked beforehand.)
     {
         DBG("*stops region " + juce::String(ID) + "*");
-        associatedVoices[currentVoiceIndex]->stopNote(1.0f, true); //cycles through all voices bit by bit
-        currentVoiceIndex = (currentVoiceIndex + 1) % associatedVoices.size(); //next time, play the next voice
+        if (currentVoice != nullptr)
+        {
+            currentVoice->stopNote(1.0f, true); //the other voices of this region may still be tailing off
+            currentVoice = nullptr;
+        }
         isPlaying = false;
 
         //try to set the button's toggle state to "up" (needs to be done cross-thread for MIDI messages because they do not run on the same thread as couriers and clicks)
@@ -658,15 +697,14 @@ void SegmentedRegion::stopPlaying(bool toggleButtonState)
         {
             if (juce::MessageManager::getInstance()->isThisTheMessageThread())
             {
+                pendingToggleState.store(false); //in case an older asynchronous update is still pending
                 setToggleState(false, juce::NotificationType::dontSendNotification);
             }
             else
             {
-                juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data)
-                    {
-                        static_cast<SegmentedRegion*>(data)->setToggleState(false, juce::NotificationType::dontSendNotification);
-                        return static_cast<void*>(nullptr);
-                    }, this);
+                //don't wait for the message thread: couriers and MIDI messages start and stop regions on the audio thread
+                pendingToggleState.store(false);
+                triggerAsyncUpdate();
             }
         }
 
@@ -677,6 +715,10 @@ void SegmentedRegion::stopPlaying(bool toggleButtonState)
         DBG("didn't need to stop region " + juce::String(ID) + ".");
     }
 }
+void SegmentedRegion::handleAsyncUpdate()
+{
+    setToggleState(pendingToggleState.load(), juce::NotificationType::dontSendNotification);
+}
 void SegmentedRegion::panic()
 {
     if (isPlaying || shouldBePlaying()) //region is playing, but it was requested that it shouldn't do so anymore. (the audio file needn't be checked because the region cannot start playing without the file having been checked beforehand.)
@@ -691,6 +733,7 @@ void SegmentedRegion::panic()
         {
             (*itVoice)->stopNote(1.0f, false); //no tailoff!
         }
+        currentVoice = nullptr;
 
         //try to set the button's toggle state to "up" (needs to be done cross-thread for MIDI messages because they do not run on the same thread as couriers and clicks)
         if (juce::MessageManager::getInstance()->isThisTheMessageThread())
@@ -863,6 +906,47 @@ juce::Array<Voice*> SegmentedRegion::getAssociatedVoices()
     output.addArray(associatedVoices);
     return output;
 }
+int SegmentedRegion::getPolyphony()
+{
+    return associatedVoices.size();
+}
+void SegmentedRegion::setPolyphony(int newPolyphony)
+{
+    newPolyphony = juce::jlimit(1, AudioEngine::maxPolyphony, newPolyphony);
+    if (newPolyphony == associatedVoices.size())
+    {
+        return;
+    }
+
+    bool wasPlaying = isPlaying;
+    isPlaying = false;
+    currentVoice = nullptr;
+
+    audioEngine->setRegionPolyphony(getID(), newPolyphony); //the new voices have the same parameters and modulations as the old ones
+    associatedVoices = audioEngine->getVoicesWithID(getID());
+
+    //the new voices don't have a file yet
+    if (stream != nullptr)
+    {
+        for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
+        {
+            (*itVoice)->setOsc(stream);
+        }
+    }
+    else if (sample != nullptr)
+    {
+        auto playableSample = audioEngine->getSampleStore()->getPlayableSample(sample);
+        for (auto itVoice = associatedVoices.begin(); itVoice != associatedVoices.end(); itVoice++)
+        {
+            (*itVoice)->setOsc(playableSample);
+        }
+    }
+
+    if (wasPlaying)
+    {
+        startPlaying(false); //the old voice has been removed -> continue on one of the new ones
+    }
+}
 juce::String SegmentedRegion::getFileName()
 {
     return audioFileName;
@@ -897,43 +981,11 @@ bool SegmentedRegion::serialise(juce::XmlElement* xmlRegion, juce::Array<juce::M
 
 
 
-    //store buffer in attachedData
-    int numChannels = buffer.getNumChannels();
-    int numSamples = buffer.getNumSamples();
-    size_t bufferMemorySize = static_cast<size_t>(numChannels * numSamples) * sizeof(float);
-
-    if (bufferMemorySize > 0)
-    {
-        //serialise buffer
-        juce::MemoryBlock bufferMemory(bufferMemorySize);
-        juce::MemoryOutputStream bufferStream (bufferMemory, false); //by using this stream, the samples can be written in a certain endian (unlike memBuffer.append()), ensuring portability. little endian will be used.
-
-        //prepend size and number of the channels so that they can be read correctly
-        bufferStream.writeInt(numChannels);
-        bufferStream.writeInt(numSamples);
-        bufferStream.flush();
-
-        //copy the content of the buffer - unfortunately, the channels can't be written as a whole, so it has to be done sample-by-sample...
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            //bufferMemory.append(buffer.getReadPointer(ch), static_cast<size_t>(numSamples) * sizeof(float)); //while this would be able to copy a full channel, it wouldn't ensure a specific endian, causing portability issues!
-            auto* samples = buffer.getReadPointer(ch);
-
-            for (int s = 0; s < numSamples; ++s)
-            {
-                bufferStream.writeFloat(samples[s]);
-            }
-            bufferStream.flush();
-        }
+    //streamed files are too large to be stored in attachedData, so only their path is stored
+    xmlRegion->setAttribute("streamedFilePath", stream != nullptr ? stream->getFile().getFullPathName() : "");
 
-        attachedData->add(bufferMemory);
-        xmlRegion->setAttribute("bufferMemory_index", attachedData->size() - 1);
-    }
-    else //bufferMemorySize == 0
-    {
-        //no buffer contained -> nothing to serialise
-        xmlRegion->setAttribute("bufferMemory_index", -1); //nothing attached
-    }
+    //store sample in attachedData (or refer to the data of another region which uses the same sample)
+    xmlRegion->setAttribute("bufferMemory_index", audioEngine->getSampleStore()->serialise(sample, attachedData)); //-1 if there's no sample
 
     DBG(juce::String(serialisationSuccessful ? "SegmentedRegion has been serialised." : "SegmentedRegion could not be serialised."));
     return serialisationSuccessful;
@@ -950,6 +1002,8 @@ bool SegmentedRegion::deserialise(juce::XmlElement* xmlRegion, juce::Array<juce:
         shouldBeToggleable = xmlRegion->getBoolAttribute("shouldBeToggleable", false);
         p.clear();
         p.restoreFromString(xmlRegion->getStringAttribute("path", ""));
+        outlineTable.rebuild(p);
+        hitMask.rebuild(p, getWidth(), getHeight());
         fillColour = juce::Colour::fromString(xmlRegion->getStringAttribute("fillColour", juce::Colours::black.toString()));
 
         midiChannel = xmlRegion->getIntAttribute("midiChannel", -1);
@@ -996,46 +1050,42 @@ bool SegmentedRegion::deserialise(juce::XmlElement* xmlRegion, juce::Array<juce:
                 int polyphony = xmlRegion->getIntAttribute("polyphony", 1);
                 if (associatedVoices.size() != polyphony)
                 {
+                    currentVoice = nullptr;
                     audioEngine->removeVoicesWithID(getID());
                     audioEngine->initialiseVoicesForRegion(getID(), polyphony); //initialises the given amount of voices for this region
                     associatedVoices = audioEngine->getVoicesWithID(getID()); //update associated voices
                 }
 
                 //restore buffer from attachedData
-                int bufferMemoryIndex = xmlRegion->getIntAttribute("bufferMemory_index", -1);
-                if (bufferMemoryIndex >= 0 && bufferMemoryIndex < attachedData->size())
+                juce::String streamedFilePath = xmlRegion->getStringAttribute("streamedFilePath", "");
+                StreamingAudioFile::Ptr restoredStream = nullptr;
+                if (streamedFilePath.isNotEmpty())
+                {
+                    restoredStream = audioEngine->getFileLoader()->openStream(juce::File(streamedFilePath));
+                }
+
+                SampleStore::Sample::Ptr restoredSample = nullptr;
+                if (restoredStream == nullptr)
+                {
+                    restoredSample = audioEngine->getSampleStore()->deserialise(xmlRegion->getIntAttribute("bufferMemory_index", -1), origSampleRate, attachedData); //nullptr if not contained
+                }
+
+                if (restoredStream != nullptr)
+                {
+                    //streamed file -> reopen it
+                    setStream(restoredStream, audioFileName); //correctly updates associated voices, too
+                }
+                else if (restoredSample != nullptr)
                 {
-                    //buffer data contained in attachedData -> get block and restore
-                    juce::MemoryBlock bufferMemory = (*attachedData)[bufferMemoryIndex];
-                    juce::MemoryInputStream bufferStream(bufferMemory, false); //by using this stream, the samples can be read in a certain endian, ensuring portability. little endian will be used.
-
-                    //get the size and number of the channels so that they can be read correctly
-                    int numChannels = bufferStream.readInt();
-                    int numSamples = bufferStream.readInt();
-                    juce::AudioSampleBuffer tempBuffer(numChannels, numSamples);
-
-                    //copy the content of the buffer - unfortunately, the channels can't be written as a whole, so it has to be done sample-by-sample...
-                    for (int ch = 0; ch < numChannels; ++ch)
-                    {
-                        //bufferMemory.append(buffer.getReadPointer(ch), static_cast<size_t>(numSamples) * sizeof(float)); //while this would be able to copy a full channel, it wouldn't ensure a specific endian, causing portability issues!
-                        auto* samples = tempBuffer.getWritePointer(ch);
-
-                        for (int s = 0; s < numSamples; ++s)
-                        {
-                            samples[s] = bufferStream.readFloat();
-                        }
-                    }
-
-                    setBuffer(tempBuffer, audioFileName, origSampleRate); //correctly updates associated voices, too
+                    //sample data contained in attachedData -> restore (samples shared by several regions are only restored once)
+                    setSample(restoredSample, audioFileName); //correctly updates associated voices, too
                 }
                 else
                 {
                     //buffer data not contained in attachedData (buffer was probably empty)
 
-                    DBG("buffer not contained in attachedData. this might be because the buffer was simply empty.");
-                    audioFileName = "";
-                    origSampleRate = 0.0;
-                    setBuffer(juce::AudioSampleBuffer(), "", 0.0); //sets buffer to be empty. correctly updates associated voices, too
+                    DBG(streamedFilePath.isNotEmpty() ? "the streamed file " + streamedFilePath + " couldn't be reopened. it might have been moved or deleted." : "buffer not contained in attachedData. this might be because the buffer was simply empty.");
+                    setSample(nullptr, ""); //removes the sample. correctly updates associated voices, too
                 }
             }
         }
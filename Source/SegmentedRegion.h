@@ -29,11 +29,14 @@ struct Voice;
 class RegionEditorWindow;
 
 #include "RegionLfo.h"
+#include "PathArcLengthTable.h"
+#include "OutlineWaveTableBuilder.h"
+#include "RegionMask.h"
 
 //==============================================================================
 /*
 */
-class SegmentedRegion final : public juce::DrawableButton, public juce::Timer, public juce::MidiKeyboardState::Listener, public juce::TooltipClient
+class SegmentedRegion final : public juce::DrawableButton, public juce::Timer, public juce::MidiKeyboardState::Listener, public juce::TooltipClient, public SampleStore::Listener, private juce::AsyncUpdater
 {
 public:
     SegmentedRegion(const juce::Path& outline, const juce::Rectangle<float>& relativeBounds, const juce::Rectangle<int>& parentBounds, juce::Colour fillColour, AudioEngine* audioEngine)/* :
@@ -65,13 +68,17 @@ public:
 
     void clicked(const juce::ModifierKeys& modifiers) override;
 
-    void setBuffer(juce::AudioSampleBuffer newBuffer, juce::String fileName, double origSampleRate);
+    void setSample(SampleStore::Sample::Ptr newSample, juce::String fileName); //nullptr removes the file
+    void playableSampleReady(SampleStore::Sample::Ptr original, SampleStore::Sample::Ptr playable) override;
+    void setStream(StreamingAudioFile::Ptr newStream, juce::String fileName); //for long files that are streamed from disk instead of being kept in memory
 
     void renderLfoWaveform();
+    void lfoRateChanged(); //re-renders the LFO's waveform if it needs to be band-limited differently at the new rate or update interval
 
     int getID();
     bool tryChangeID(int newID);
 
+    const juce::Path& getOutline(); //in the region's own coordinates
     juce::Point<float> getFocusPoint();
     void setFocusPoint(juce::Point<float> newFocusPoint);
 
@@ -104,6 +111,8 @@ public:
     RegionLfo* getAssociatedLfo();
     AudioEngine* getAudioEngine();
     juce::Array<Voice*> getAssociatedVoices();
+    int getPolyphony();
+    void setPolyphony(int newPolyphony); //number of voices that this region can play simultaneously. if they're all busy, the VoicePool steals one of them
     juce::String getFileName();
 
     bool serialise(juce::XmlElement* xmlRegion, juce::Array<juce::MemoryBlock>* attachedData);
@@ -131,9 +140,12 @@ private:
     bool isPlaying_click = false; //states whether the user has attempted to play the region by clicking it.
     bool isPlaying_courier = false; //states whether one or more couriers are within a region, causing it to play.
     bool isPlaying_midi = false; //states whether the MIDI note associated with this region is pressed, causing the region to play.
-    int currentVoiceIndex = 0;
+    Voice* currentVoice = nullptr; //voice that has been started by the VoicePool the last time this region started playing
     int currentCourierCount = 0; //used to determine whether a region should start/stop playing when a courier enters/exits it (depending on whether there are already couriers contained at that time)
 
+    std::atomic<bool> pendingToggleState { false }; //toggle state to be set on the message thread when the region is started or stopped from another thread (couriers, MIDI)
+    void handleAsyncUpdate() override;
+
     int midiChannel = -1; //-1 = none, 0 = any, 1...16 = [channel]
     int noteNumber = -1; //-1 = none, 0...127 = [note]
 
@@ -142,6 +154,10 @@ private:
     static const float lfoLineThickness;
 
     juce::Path p; //also acts as a hitbox
+    PathArcLengthTable outlineTable; //finds points along p quickly. rebuilt whenever p changes
+    OutlineWaveTableBuilder waveTableBuilder; //chooses the LFO's table length according to the outline's detail
+    int calculateLfoMaxHarmonic(); //0 if the LFO's wavetable doesn't need to be band-limited
+    RegionMask hitMask; //rasterised version of p for hit testing. rebuilt whenever p or the size of the region changes
 
     static const float focusRadius;
     juce::Point<float> focus;
@@ -165,7 +181,8 @@ private:
     juce::DrawablePath disabledImageOn; //image when disabled when toggleable and toggled on
 
     AudioEngine* audioEngine;
-    juce::AudioSampleBuffer buffer;
+    SampleStore::Sample::Ptr sample; //shared with all voices of this region (and with other regions that use the same file)
+    StreamingAudioFile::Ptr stream; //only set if the file is streamed (sample is nullptr then)
     juce::String audioFileName = "";
     double origSampleRate = 0.0;
 
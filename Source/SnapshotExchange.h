@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    SnapshotExchange.h
+    Created: 17 Oct 2026 3:02:37pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/// <summary>
+/// Hands immutable, reference-counted snapshots (e.g. a new audio file or wavetable) from the message thread to the audio thread (read-copy-update).
+/// The message thread builds the snapshot completely and publishes it; the audio thread picks it up at its next block boundary without ever blocking, allocating or deleting anything.
+/// The snapshot that the audio thread replaces is kept in the exchange and released by the message thread during the next publish (or releaseRetired).
+/// </summary>
+/// <typeparam name="ObjectType">Type of the snapshot. Must inherit from juce::ReferenceCountedObject.</typeparam>
+template <class ObjectType>
+class SnapshotExchange
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<ObjectType>;
+
+    SnapshotExchange()
+    { }
+    ~SnapshotExchange()
+    { }
+
+    /// <summary>
+    /// Publishes a new snapshot. Must only be called from the message thread. Replaces any snapshot that hasn't been collected yet.
+    /// </summary>
+    void publish(ObjectType* newSnapshot)
+    {
+        Ptr replaced(newSnapshot);
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            std::swap(pending, replaced);
+            hasPending.store(true, std::memory_order_release);
+        }
+        //replaced now contains the previously pending or retired snapshot, which is released here (outside of the lock)
+    }
+
+    /// <summary>
+    /// If a new snapshot has been published, swaps it into current. Realtime-safe: never blocks, allocates or deletes.
+    /// If the message thread is publishing at the same time, the snapshot is collected during the next call.
+    /// </summary>
+    /// <param name="current">The snapshot used by the audio thread. Its previous value will be released by the message thread later on.</param>
+    /// <returns>True if current has changed, false otherwise.</returns>
+    bool collect(Ptr& current)
+    {
+        if (!hasPending.load(std::memory_order_acquire))
+        {
+            return false; //the common case - doesn't even touch the lock
+        }
+
+        const juce::SpinLock::ScopedTryLockType sl(lock);
+        if (!sl.isLocked() || !hasPending.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        std::swap(current, pending); //moves only, so no reference counts change here. the old snapshot is retired into pending
+        hasPending.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// <summary>
+    /// Releases the snapshot that has last been replaced by collect (if any). Must only be called from the message thread.
+    /// </summary>
+    void releaseRetired()
+    {
+        Ptr retired;
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if (hasPending.load(std::memory_order_relaxed))
+            {
+                return; //pending hasn't been collected yet, so it's not retired
+            }
+            std::swap(pending, retired);
+        }
+    }
+
+private:
+    juce::SpinLock lock; //only ever held for a pointer swap
+    Ptr pending; //either the snapshot that hasn't been collected yet (hasPending) or the one that has last been retired
+    std::atomic<bool> hasPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SnapshotExchange)
+};
@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    StreamingAudioFile.cpp
+    Created: 17 Oct 2026 5:03:18pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "StreamingAudioFile.h"
+
+//constants
+const double StreamingAudioFile::headLengthSeconds = 3.0;
+const int StreamingAudioFile::blockSize = 16384;
+const int StreamingAudioFile::numCacheSlots = 32; //~11 seconds at 48kHz
+const int StreamingAudioFile::numReadAheadBlocks = 2;
+const int StreamingAudioFile::requestQueueSize = 256;
+
+
+StreamingAudioFile::StreamingAudioFile(juce::AudioFormatReader* reader, const juce::File& file, std::shared_ptr<juce::TimeSliceThread> readerThread) :
+    reader(reader),
+    file(file),
+    readerThread(readerThread),
+    requestFifo(requestQueueSize)
+{
+    jassert(this->reader != nullptr);
+
+    numSamples = static_cast<int>(juce::jmin(reader->lengthInSamples, static_cast<juce::int64>(std::numeric_limits<int>::max())));
+    numChannels = static_cast<int>(reader->numChannels);
+    sampleRate = reader->sampleRate;
+    wrapLength = juce::jmax(1, numSamples - 1);
+
+    //preload the head
+    headNumSamples = juce::jmin(numSamples, static_cast<int>(headLengthSeconds * sampleRate));
+    head.setSize(numChannels, headNumSamples);
+    reader->read(&head, 0, headNumSamples, 0, true, true);
+
+    //prepare the cache (allocated once, so that the reader thread never needs to allocate)
+    numBlocks = (numSamples + blockSize - 1) / blockSize;
+    for (int i = 0; i < numCacheSlots; ++i)
+    {
+        auto* slot = slots.add(new CacheSlot());
+        slot->samples.setSize(numChannels, blockSize);
+    }
+    slotOfBlock.reset(new std::atomic<int>[static_cast<size_t>(numBlocks)]);
+    isBlockRequested.reset(new std::atomic<bool>[static_cast<size_t>(numBlocks)]);
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        slotOfBlock[b].store(-1);
+        isBlockRequested[b].store(false);
+    }
+    requestQueue.allocate(requestQueueSize, true);
+
+    readerThread->addTimeSliceClient(this);
+
+    DBG("streaming " + file.getFileName() + ": " + juce::String(numSamples) + " samples, " + juce::String(numBlocks) + " blocks, head: " + juce::String(headNumSamples) + " samples");
+}
+StreamingAudioFile::~StreamingAudioFile()
+{
+    readerThread->removeTimeSliceClient(this); //waits until the reader thread isn't using this object anymore
+    slots.clear(true);
+}
+
+int StreamingAudioFile::getNumSamples()
+{
+    return numSamples;
+}
+int StreamingAudioFile::getNumChannels()
+{
+    return numChannels;
+}
+double StreamingAudioFile::getSampleRate()
+{
+    return sampleRate;
+}
+juce::File StreamingAudioFile::getFile()
+{
+    return file;
+}
+
+void StreamingAudioFile::readSamples(int channel, juce::int64 startIndex, int numSamplesToRead, float* destination)
+{
+    usageClock.fetch_add(1, std::memory_order_relaxed);
+
+    //wrap the start index (the caller's indices are at most a few samples out of range)
+    juce::int64 index = startIndex % wrapLength;
+    if (index < 0)
+    {
+        index += wrapLength;
+    }
+
+    int lastBlock = -1;
+    while (numSamplesToRead > 0)
+    {
+        int position = static_cast<int>(index);
+        int numSamplesInRun;
+
+        if (position < headNumSamples)
+        {
+            //preloaded
+            numSamplesInRun = juce::jmin(numSamplesToRead, headNumSamples - position, wrapLength - position);
+            juce::FloatVectorOperations::copy(destination, head.getReadPointer(channel, position), numSamplesInRun);
+        }
+        else
+        {
+            //cached (or missing)
+            int block = position / blockSize;
+            int offsetInBlock = position - block * blockSize;
+            numSamplesInRun = juce::jmin(numSamplesToRead, blockSize - offsetInBlock, wrapLength - position);
+
+            if (!readFromCache(channel, block, offsetInBlock, numSamplesInRun, destination))
+            {
+                juce::FloatVectorOperations::clear(destination, numSamplesInRun); //not loaded yet -> silence
+                requestBlock(block);
+            }
+            lastBlock = block;
+        }
+
+        destination += numSamplesInRun;
+        numSamplesToRead -= numSamplesInRun;
+        index += numSamplesInRun;
+        if (index >= wrapLength)
+        {
+            index -= wrapLength;
+        }
+    }
+
+    //read ahead, so that sequential playback never runs into missing blocks
+    int currentBlock = (lastBlock >= 0) ? lastBlock : static_cast<int>(index) / blockSize;
+    for (int i = 1; i <= numReadAheadBlocks; ++i)
+    {
+        int block = (currentBlock + i) % numBlocks;
+        if (block * blockSize >= headNumSamples && slotOfBlock[block].load(std::memory_order_relaxed) < 0)
+        {
+            requestBlock(block);
+        }
+    }
+}
+
+bool StreamingAudioFile::readFromCache(int channel, int blockIndex, int offsetInBlock, int numSamplesToRead, float* destination)
+{
+    int slotIndex = slotOfBlock[blockIndex].load(std::memory_order_acquire);
+    if (slotIndex < 0)
+    {
+        return false;
+    }
+
+    auto* slot = slots.getUnchecked(slotIndex);
+    int versionBefore = slot->version.load(std::memory_order_acquire);
+    if ((versionBefore & 1) != 0 || slot->blockIndex.load(std::memory_order_acquire) != blockIndex)
+    {
+        return false; //being (re)loaded
+    }
+
+    juce::FloatVectorOperations::copy(destination, slot->samples.getReadPointer(channel, offsetInBlock), numSamplesToRead);
+    slot->lastUsed.store(usageClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->version.load(std::memory_order_relaxed) == versionBefore; //otherwise, the slot has been overwritten while copying
+}
+
+void StreamingAudioFile::requestBlock(int blockIndex)
+{
+    if (isBlockRequested[blockIndex].load(std::memory_order_relaxed))
+    {
+        return; //already requested
+    }
+
+    const juce::SpinLock::ScopedTryLockType sl(requestWriteLock);
+    if (!sl.isLocked())
+    {
+        return; //another voice is requesting right now -> try again during the next sub-block
+    }
+
+    int start1, size1, start2, size2;
+    requestFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 < 1)
+    {
+        return; //queue full
+    }
+
+    requestQueue[size1 > 0 ? start1 : start2] = blockIndex;
+    requestFifo.finishedWrite(1);
+    isBlockRequested[blockIndex].store(true, std::memory_order_relaxed);
+}
+
+int StreamingAudioFile::useTimeSlice()
+{
+    int numHandledRequests = 0;
+
+    int start1, size1, start2, size2;
+    requestFifo.prepareToRead(requestFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1 + size2; ++i)
+    {
+        int blockIndex = requestQueue[i < size1 ? start1 + i : start2 + i - size1];
+        if (slotOfBlock[blockIndex].load() < 0)
+        {
+            loadBlock(blockIndex);
+        }
+        isBlockRequested[blockIndex].store(false, std::memory_order_relaxed);
+        ++numHandledRequests;
+    }
+    requestFifo.finishedRead(size1 + size2);
+
+    return numHandledRequests > 0 ? 1 : 5; //ms until the next call. check again quickly while the voices are requesting blocks
+}
+
+void StreamingAudioFile::loadBlock(int blockIndex)
+{
+    //replace the least recently used slot
+    int slotIndex = 0;
+    juce::uint32 now = usageClock.load(std::memory_order_relaxed);
+    juce::uint32 oldestAge = 0;
+    for (int i = 0; i < slots.size(); ++i)
+    {
+        auto* slot = slots.getUnchecked(i);
+        if (slot->blockIndex.load() < 0)
+        {
+            slotIndex = i; //empty
+            break;
+        }
+
+        juce::uint32 age = now - slot->lastUsed.load(std::memory_order_relaxed);
+        if (age >= oldestAge)
+        {
+            oldestAge = age;
+            slotIndex = i;
+        }
+    }
+
+    auto* slot = slots.getUnchecked(slotIndex);
+    int previousBlockIndex = slot->blockIndex.load();
+    if (previousBlockIndex >= 0)
+    {
+        slotOfBlock[previousBlockIndex].store(-1, std::memory_order_release);
+    }
+
+    slot->version.fetch_add(1, std::memory_order_acq_rel); //odd -> being written
+    slot->blockIndex.store(blockIndex, std::memory_order_release);
+
+    juce::int64 startSample = static_cast<juce::int64>(blockIndex) * blockSize;
+    int numSamplesInBlock = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), static_cast<juce::int64>(numSamples) - startSample));
+    reader->read(&slot->samples, 0, numSamplesInBlock, startSample, true, true);
+    if (numSamplesInBlock < blockSize)
+    {
+        slot->samples.clear(numSamplesInBlock, blockSize - numSamplesInBlock);
+    }
+
+    slot->lastUsed.store(now, std::memory_order_relaxed); //freshly loaded blocks shouldn't be replaced right away
+    slot->version.fetch_add(1, std::memory_order_release); //even -> ready
+    slotOfBlock[blockIndex].store(slotIndex, std::memory_order_release);
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    StreamingAudioFile.h
+    Created: 17 Oct 2026 5:03:18pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+/// <summary>
+/// Audio file that is too long to be kept in memory completely. The first few seconds (the head) are preloaded, the rest is streamed from disk:
+/// the file is divided into blocks, and a fixed number of them are kept in a block cache which is filled by a background (TimeSliceThread) reader.
+/// Voices read from the file via readSamples, which is realtime-safe. It also requests the blocks that will be needed soon (read-ahead),
+/// so that sequential playback is served from the cache. Random-access jumps (e.g. from playback position modulation) are served once their block has been loaded.
+/// Until then, the missing samples are silent.
+/// Like in-memory files, the last sample of the file is treated as being equal to the first, i.e. positions wrap at getNumSamples() - 1.
+/// </summary>
+class StreamingAudioFile : public juce::ReferenceCountedObject, private juce::TimeSliceClient
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<StreamingAudioFile>;
+
+    /// <summary>
+    /// Opens the file and preloads its head. May take a moment, so it should be called from a background thread.
+    /// </summary>
+    /// <param name="reader">Reader of the file. The StreamingAudioFile takes ownership of it.</param>
+    /// <param name="file">The file that is being streamed (used for serialisation)</param>
+    /// <param name="readerThread">Thread that fills the block cache. Kept alive by this object.</param>
+    StreamingAudioFile(juce::AudioFormatReader* reader, const juce::File& file, std::shared_ptr<juce::TimeSliceThread> readerThread);
+    ~StreamingAudioFile() override;
+
+    int getNumSamples();
+    int getNumChannels();
+    double getSampleRate();
+    juce::File getFile();
+
+    /// <summary>
+    /// Copies samples of one channel into destination. The indices wrap around at getNumSamples() - 1. Realtime-safe.
+    /// </summary>
+    void readSamples(int channel, juce::int64 startIndex, int numSamplesToRead, float* destination);
+
+    static const double headLengthSeconds; //length of the preloaded part of the file
+    static const int blockSize; //samples per channel per cached block
+
+private:
+    int useTimeSlice() override;
+
+    struct CacheSlot
+    {
+        juce::AudioBuffer<float> samples;
+        std::atomic<int> blockIndex { -1 };
+        std::atomic<int> version { 0 }; //odd while the slot is being written (seqlock)
+        std::atomic<juce::uint32> lastUsed { 0 };
+    };
+
+    bool readFromCache(int channel, int blockIndex, int offsetInBlock, int numSamplesToRead, float* destination);
+    void requestBlock(int blockIndex);
+    void loadBlock(int blockIndex);
+
+    std::unique_ptr<juce::AudioFormatReader> reader; //only used by the reader thread after construction
+    juce::File file;
+    std::shared_ptr<juce::TimeSliceThread> readerThread;
+
+    int numSamples = 0;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    int wrapLength = 1;
+
+    juce::AudioBuffer<float> head;
+    int headNumSamples = 0;
+
+    //block cache
+    int numBlocks = 0;
+    juce::OwnedArray<CacheSlot> slots;
+    std::unique_ptr<std::atomic<int>[]> slotOfBlock; //for every block: index of the slot that contains it, or -1
+    std::atomic<juce::uint32> usageClock { 0 };
+
+    //requests (ring buffer of block indices, written by the voices, read by the reader thread)
+    juce::AbstractFifo requestFifo;
+    juce::HeapBlock<int> requestQueue;
+    juce::SpinLock requestWriteLock; //only try-locked by the voices, so that several threads can request blocks without ever blocking
+    std::unique_ptr<std::atomic<bool>[]> isBlockRequested; //avoids requesting the same block over and over again while it's loading
+
+    static const int numCacheSlots;
+    static const int numReadAheadBlocks;
+    static const int requestQueueSize;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingAudioFile)
+};
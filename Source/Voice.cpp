@@ -9,6 +9,10 @@
 */
 
 #include "Voice.h"
+#include "VoicePool.h"
+
+//constants
+const double Voice::stealRampSeconds = 0.005;
 
 Voice::Voice() :
     playbackMultApprox([](double semis) { return std::pow(2.0, semis / 12.0); }, -60.0, 60.0, 60 + 60 + 1), //1 point per semi should be enough
@@ -34,11 +38,10 @@ Voice::Voice() :
     currentState = states[static_cast<int>(currentStateIndex)];
 
     pitchQuantisationFuncPt = &Voice::getQuantisedPitch_continuous; //default: no quantisation (cheapest)
+    interpolationFuncPt = SamplePlaybackKernel::getInterpolationFunction(currentInterpolationMethod);
     setPitchQuantisationScale_minor(); //set to minor scale by default (will be overwritten once the player chooses a different quantisation method than continous, but it's safer to initialise the array just in case)
 
-    filter.parameters->setCutOffFrequency(48000.0, 22050.0); //sample rate will be set again later during preparation
-    filter.parameters->type = juce::dsp::StateVariableFilter::StateVariableFilterType::lowPass; //WIP: maybe make other types avaible too
-    filter.snapToZero(); //the filter will be doing sample-by-sample processing
+    filter.setType(juce::dsp::StateVariableFilter::StateVariableFilterType::lowPass); //WIP: maybe make other types avaible too
 
     //DBG("init base level: " + juce::String(levelParameter.getBaseValue()));
     //DBG("init base playback pos: " + juce::String(playbackPositionParameter.getBaseValue()));
@@ -50,10 +53,10 @@ Voice::Voice(int regionID) :
     ID = regionID;
 }
 
-Voice::Voice(juce::AudioSampleBuffer buffer, int origSampleRate, int regionID) :
+Voice::Voice(SampleStore::Sample::Ptr sample, int regionID) :
     Voice::Voice(regionID)
 {
-    setOsc(buffer, origSampleRate);
+    setOsc(sample);
 }
 
 Voice::~Voice()
@@ -108,7 +111,6 @@ Voice::~Voice()
     jassert(unsubscribedModulators == 6);
 
     //release osc
-    delete osc;
     osc = nullptr;
 
     //release states
@@ -134,24 +136,50 @@ void Voice::prepare(const juce::dsp::ProcessSpec& spec)
     setCurrentPlaybackSampleRate(spec.sampleRate);
     envelope.setSampleRate(spec.sampleRate);
 
-    filter.prepare(spec);
+    //allocate scratch memory for the block-wise rendering
+    playbackScratchSize = (spec.maximumBlockSize > 0) ? static_cast<int>(spec.maximumBlockSize) : defaultPlaybackScratchSize;
+    playbackScratch.setSize(juce::jmax(2, static_cast<int>(spec.numChannels)), playbackScratchSize, false, true, true);
+
+    filter.prepare(spec.sampleRate, playbackScratch.getNumChannels()); //also rebuilds the coefficient table for the new sample rate
+    playbackGains.allocate(playbackScratchSize, true);
+    readPositions.allocate(playbackScratchSize, true);
+    streamWindow.allocate(streamWindowSize + 2 * streamWindowMargin, true);
+    mipScratch.allocate(playbackScratchSize, true);
+    mipReadPositions.allocate(playbackScratchSize, true);
+    stealRampLength = juce::jmax(1, static_cast<int>(spec.sampleRate * stealRampSeconds));
 
+    applyPendingOsc(); //the audio thread isn't running during prepare, so any file that has been set in the meantime can be applied right away
     currentState->prepared(spec.sampleRate);
 }
 
-void Voice::setOsc(juce::AudioSampleBuffer buffer, int origSampleRate)
+void Voice::setOsc(SampleStore::Sample::Ptr sample)
 {
-    if (osc == nullptr)
-    {
-        osc = new SamplerOscillator(buffer, origSampleRate);
-    }
-    else
+    //the new oscillator is built on the calling (message) thread, so that the audio thread only has to swap a pointer. the sample itself is shared, not copied
+    oscExchange.publish(new SamplerOscillator(sample));
+}
+void Voice::setOsc(StreamingAudioFile::Ptr stream)
+{
+    oscExchange.publish(new SamplerOscillator(stream));
+}
+void Voice::applyPendingOsc()
+{
+    //remember the previous file, so that switching between a sample and its resampled copy doesn't restart playback
+    bool hadSample = osc != nullptr && osc->sample != nullptr;
+    juce::uint64 previousHash = hadSample ? osc->sample->getHash() : 0;
+    int previousNumSamples = (osc != nullptr) ? osc->getNumSamples() : 0;
+
+    if (oscExchange.collect(osc))
     {
-        osc->fileBuffer = buffer;
-        osc->origSampleRate = origSampleRate;
+        if (hadSample && osc->sample != nullptr && osc->sample->getHash() == previousHash && previousNumSamples > 1)
+        {
+            currentBufferPos *= static_cast<double>(osc->getNumSamples() - 1) / static_cast<double>(previousNumSamples - 1); //same relative position
+        }
+        else
+        {
+            currentBufferPos = 0.0;
+        }
+        currentState->wavefileChanged(osc->getNumSamples());
     }
-    currentBufferPos = 0.0;
-    currentState->wavefileChanged(buffer.getNumSamples());
 }
 
 bool Voice::canPlaySound(juce::SynthesiserSound* sound)
@@ -183,6 +211,7 @@ void Voice::startNote(int midiNoteNumber, float velocity,
     currentState->playableChanged(true);
 
     updateBufferPosDelta();
+    bufferPosDeltaIncrement = 0.0;
 
     //DBG("note on. current state index: " + juce::String(static_cast<int>(currentStateIndex)));
 }
@@ -200,8 +229,14 @@ void Voice::stopNote(float /*velocity*/, bool allowTailOff)
         clearCurrentNote();
         bufferPosDelta = 0.0;
         envelope.forceStop();
+        stealRequested.store(false);
+        stealRampSamplesRemaining = 0;
+        beingStolen.store(false);
         currentState->playableChanged(false);
+        signalStoppedToPool();
     }
+
+    retriggerAfterSteal.store(false); //a stolen voice which is stopped before it could restart only fades out
 }
 
 //==============================================================================
@@ -221,95 +256,289 @@ void Voice::controllerMoved(int, int) {}
 //==============================================================================
 void Voice::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    currentState->renderNextBlock(outputBuffer, startSample);
+    applyPendingOsc(); //block boundary -> pick up a new file (if any)
+    applyPendingSteal();
+    currentState->renderNextBlock(outputBuffer, startSample, numSamples);
 }
 void Voice::renderNextBlock_empty()
 {
     //nothing set -> nothing happens
 }
-void Voice::renderNextBlock_onlyLfo()
+void Voice::renderNextBlock_wave(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    //bufferPosDelta = 0.0 or no wave set -> needn't render sound
+    while (numSamples > 0)
+    {
+        int numSamplesToRender = juce::jmin(numSamples, playbackScratchSize); //should normally render everything at once
+        int numRenderedSamples = renderWave(outputBuffer, startSample, numSamplesToRender);
 
-    associatedLfo->advance();
+        if (stealRampEnded) //the voice has been faded out because it has been stolen
+        {
+            if (!finishStealing())
+            {
+                return; //the rest of the sub-block stays silent
+            }
+        }
+        else if (numRenderedSamples < numSamplesToRender) //the voice has finished playing during this sub-block
+        {
+            stopAfterEnvelopeEnded();
+            return; //the rest of the sub-block stays silent
+        }
+
+        startSample += numRenderedSamples;
+        numSamples -= numRenderedSamples;
+    }
 }
-void Voice::renderNextBlock_wave(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+int Voice::renderWave(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    //evaluate modulated values
-    updateBufferPosDelta(); //determines pitch shift
-    evaluateBufferPosModulation(); //advances currentBufferPos if required
+    jassert(numSamples <= playbackScratchSize);
+
+    const int numFileSamples = osc->getNumSamples();
+    const int numOutputChannels = outputBuffer.getNumChannels();
+    const int numUsedChannels = juce::jmin(osc->getNumChannels(), numOutputChannels, playbackScratch.getNumChannels()); //number of file channels that are actually audible
 
-    //calculate buffer position
-    double effectivePhase = static_cast<double>(currentBufferPos / static_cast<float>(osc->fileBuffer.getNumSamples())); //convert currentTablePos to currentPhase
-    //effectivePhase = std::fmod(effectivePhase, playbackPositionIntervalParameter.getModulatedValue()); //convert to new interval while preserving deltaTablePos (i.e. the frequency)!
-    effectivePhase = std::fmod(effectivePhase, playbackPositionIntervalParameter.getModulatedValue()); //convert to new interval while preserving deltaTablePos (i.e. the frequency)! note that playbackPositionIntervalParameter is a capped parameter that cannot become 0.0
-    jassert(!isnan(effectivePhase));
-    effectivePhase = std::fmod(effectivePhase + playbackPositionStartParameter.getModulatedValue(), 1.0); //shift the starting phase from 0 to the value stated by playbackPositionStartParameter and wrap, so that the value stays within [0,1) (i.e. within wavetable later on)
-    float effectiveBufferPos = static_cast<float>(effectivePhase) * static_cast<float>(osc->fileBuffer.getNumSamples() - 1); //convert phase back to index within wavetable (-1 at the end to ensure that floating-point rounding won't let the variable take on out-of-range values!)
-    //^- see updateCurrentValues method in RegionLfo for some more details
+    //control rate: evaluate all modulated values once for the entire sub-block
+    evaluateControlRateValues(numSamples);
 
-    //pre-calculate volume of the next sample (for all channels)
-    double gainAdjustment = envelope.getNextEnvelopeSample() * levelParameter.getModulatedValue(); //= envelopeLevel * level (with all modulations)
+    //calculate gains (envelope * level). this also determines whether the voice ends during this sub-block.
+    float* gains = playbackGains.get();
+    int numRenderedSamples = numSamples;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        gains[i] = static_cast<float>(envelope.getNextEnvelopeSample() * currentLevel);
+        currentLevel += levelIncrement;
 
-    //update filter position
-    filter.parameters->setCutOffFrequency(getSampleRate(), filterPositionParameter.getModulatedValue());
+        if (stealRampSamplesRemaining > 0) //stolen -> fade out quickly
+        {
+            gains[i] *= static_cast<float>(stealRampSamplesRemaining) / static_cast<float>(stealRampLength);
+            --stealRampSamplesRemaining;
 
-    //calculate sample(s)
-    for (auto i = outputBuffer.getNumChannels() - 1; i >= 0; --i)
+            if (stealRampSamplesRemaining == 0 || envelope.isIdle())
+            {
+                stealRampSamplesRemaining = 0;
+                stealRampEnded = true;
+                numRenderedSamples = i + 1;
+                break;
+            }
+        }
+
+        if (envelope.isIdle()) //has finished playing (including release). may also occur if the sample rate suddenly changed, but in theory, that shouldn't happen I think
+        {
+            numRenderedSamples = i + 1;
+            break;
+        }
+    }
+    currentGain.store(gains[numRenderedSamples - 1], std::memory_order_relaxed);
+
+    //calculate read positions (also advances currentBufferPos)
+    const double playbackSpeed = std::abs(bufferPosDelta); //at the beginning of the sub-block
+    calculateReadPositions(numRenderedSamples, numFileSamples);
+
+    if (numUsedChannels == 0)
     {
-        //auto currentSample = (osc->fileBuffer.getSample(i % osc->fileBuffer.getNumChannels(), (int)currentBufferPos)) * gainAdjustment;
-        auto currentSample = (osc->fileBuffer.getSample(i % osc->fileBuffer.getNumChannels(), static_cast<int>(effectiveBufferPos))) * gainAdjustment;
-        currentSample = filter.processSample(currentSample);
-        outputBuffer.addSample(i, sampleIndex, (float)currentSample);
+        return numRenderedSamples; //nothing audible (e.g. a sample without channels). the envelope and the playback position have still advanced, so the voice ends as usual
     }
 
-    if (envelope.isIdle()) //has finished playing (including release). may also occur if the sample rate suddenly changed, but in theory, that shouldn't happen I think
+    //read samples, apply gains and filter
+    if (osc->stream != nullptr)
     {
-        //stop note
-        clearCurrentNote();
-        bufferPosDelta = 0.0;
-        currentState->playableChanged(false);
+        readStreamedSamples(numUsedChannels, numRenderedSamples);
+    }
+    else if (osc->mipMap != nullptr && playbackSpeed > 1.0)
+    {
+        readMipMappedSamples(numUsedChannels, numFileSamples, numRenderedSamples, playbackSpeed);
+    }
+    else
+    {
+        for (int c = 0; c < numUsedChannels; ++c)
+        {
+            (*interpolationFuncPt)(osc->sample->getBuffer().getReadPointer(c), numFileSamples, readPositions.get(), playbackScratch.getWritePointer(c), numRenderedSamples);
+        }
+    }
+    for (int c = 0; c < numUsedChannels; ++c)
+    {
+        float* channelSamples = playbackScratch.getWritePointer(c);
+        juce::FloatVectorOperations::multiply(channelSamples, gains, numRenderedSamples);
+        filter.processBlock(channelSamples, c, numRenderedSamples);
+    }
+
+    //mix into the output
+    for (int i = 0; i < numOutputChannels; ++i)
+    {
+        juce::FloatVectorOperations::add(outputBuffer.getWritePointer(i, startSample), playbackScratch.getReadPointer(i % numUsedChannels), numRenderedSamples);
+    }
+
+    return numRenderedSamples;
+}
+void Voice::readMipMappedSamples(int numUsedChannels, int numFileSamples, int numSamples, double playbackSpeed)
+{
+    //level n is band-limited to 1/2^n of the original bandwidth. floor(log2(speed)) is crossfaded with the next (narrower) level over each octave:
+    //at speed 1, only level 0 plays, and the bandwidth falls continuously from there instead of jumping at the octaves.
+    const int numLevels = osc->mipMap->getNumLevels();
+    const double octave = std::log2(playbackSpeed);
+    int lowerLevel = static_cast<int>(std::floor(octave));
+    float upperGain = static_cast<float>(octave - static_cast<double>(lowerLevel)); //[0, 1)
+    if (lowerLevel >= numLevels)
+    {
+        //faster than the narrowest level can handle -> the narrowest level is as good as it gets
+        lowerLevel = numLevels;
+        upperGain = 0.0f;
+    }
+    const double* positions = readPositions.get();
+
+    for (int level = lowerLevel; level <= lowerLevel + 1; ++level)
+    {
+        bool isUpperLevel = level > lowerLevel;
+        if (isUpperLevel && upperGain <= 0.0f)
+        {
+            break;
+        }
+
+        //the positions refer to level 0 -> scale them to the level's length (all levels have the same duration)
+        const juce::AudioSampleBuffer& levelBuffer = (level == 0) ? osc->sample->getBuffer() : osc->mipMap->getLevel(level);
+        const int levelNumSamples = levelBuffer.getNumSamples();
+        const double* levelPositions = positions;
+        if (level > 0)
+        {
+            double levelWrapLength = static_cast<double>(levelNumSamples - 1);
+            double scale = levelWrapLength / static_cast<double>(juce::jmax(1, numFileSamples - 1));
+            double maxPosition = std::nextafter(levelWrapLength, 0.0); //guards against rounding up to the wrap length
+            for (int i = 0; i < numSamples; ++i)
+            {
+                mipReadPositions[i] = juce::jmin(positions[i] * scale, maxPosition);
+            }
+            levelPositions = mipReadPositions.get();
+        }
+
+        for (int c = 0; c < numUsedChannels; ++c)
+        {
+            float* channelSamples = playbackScratch.getWritePointer(c);
+            if (!isUpperLevel)
+            {
+                (*interpolationFuncPt)(levelBuffer.getReadPointer(c), levelNumSamples, levelPositions, channelSamples, numSamples);
+                if (upperGain > 0.0f)
+                {
+                    juce::FloatVectorOperations::multiply(channelSamples, 1.0f - upperGain, numSamples);
+                }
+            }
+            else
+            {
+                (*interpolationFuncPt)(levelBuffer.getReadPointer(c), levelNumSamples, levelPositions, mipScratch.get(), numSamples);
+                juce::FloatVectorOperations::addWithMultiply(channelSamples, mipScratch.get(), upperGain, numSamples);
+            }
+        }
+    }
+}
+void Voice::readStreamedSamples(int numUsedChannels, int numSamples)
+{
+    //the read positions are split into runs that each fit into one window. during normal playback, that's a single run per sub-block;
+    //jumps (wrapping around, playback position modulation) start a new run.
+    double* positions = readPositions.get();
+
+    int runStart = 0;
+    while (runStart < numSamples)
+    {
+        juce::int64 windowStart = static_cast<juce::int64>(positions[runStart]) - streamWindowMargin;
+        juce::int64 maxOffset = streamWindowMargin;
+
+        //extend the run as long as all positions (and their neighbours) are contained in the window
+        int runEnd = runStart + 1;
+        while (runEnd < numSamples)
+        {
+            juce::int64 offset = static_cast<juce::int64>(positions[runEnd]) - windowStart;
+            if (offset < streamWindowMargin || offset >= streamWindowMargin + streamWindowSize)
+            {
+                break;
+            }
+            maxOffset = juce::jmax(maxOffset, offset);
+            ++runEnd;
+        }
+        int windowLength = static_cast<int>(maxOffset) + streamWindowMargin + 1; //only the part of the window that is actually needed is read
+
+        //rebase the positions onto the window. the window is never wrapped by the kernel, because the positions keep their distance to its edges
+        for (int i = runStart; i < runEnd; ++i)
+        {
+            positions[i] -= static_cast<double>(windowStart);
+        }
+
+        for (int c = 0; c < numUsedChannels; ++c)
+        {
+            osc->stream->readSamples(c, windowStart, windowLength, streamWindow.get()); //wraps around at the end of the file just like the kernel would
+            (*interpolationFuncPt)(streamWindow.get(), windowLength + 1, positions + runStart, playbackScratch.getWritePointer(c, runStart), runEnd - runStart);
+        }
+
+        runStart = runEnd;
     }
 }
-void Voice::renderNextBlock_waveAndLfo(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void Voice::stopAfterEnvelopeEnded()
+{
+    //stop note
+    clearCurrentNote();
+    bufferPosDelta = 0.0;
+    filter.reset(); //the output is silent at this point, so nothing can be heard from the old states anyway
+    currentState->playableChanged(false);
+    signalStoppedToPool();
+}
+
+void Voice::evaluateControlRateValues(int numSamples)
 {
-    //evaluate modulated values
-    updateBufferPosDelta(); //determines pitch shift
-    evaluateBufferPosModulation(); //advances currentBufferPos if required
+    //modulated parameters only change when an LFO updates, so it's enough to evaluate them once per sub-block.
+    //continuous values (level, pitch) are ramped linearly towards their new values over the sub-block to avoid zipper noise.
+    //positions (start, interval, current) are held, because ramping them would audibly sweep through the sample.
+    double rampFactor = 1.0 / static_cast<double>(numSamples);
 
-    //calculate buffer position
-    double effectivePhase = static_cast<double>(currentBufferPos / static_cast<float>(osc->fileBuffer.getNumSamples())); //convert currentTablePos to currentPhase
-    //effectivePhase = std::fmod(effectivePhase, playbackPositionIntervalParameter.getModulatedValue()); //convert to new interval while preserving deltaTablePos (i.e. the frequency)!
-    effectivePhase = std::fmod(effectivePhase, playbackPositionIntervalParameter.getModulatedValue()); //convert to new interval while preserving deltaTablePos (i.e. the frequency)! note that playbackPositionIntervalParameter is a capped parameter that cannot become 0.0
-    jassert(!isnan(effectivePhase));
-    effectivePhase = std::fmod(effectivePhase + playbackPositionStartParameter.getModulatedValue(), 1.0); //shift the starting phase from 0 to the value stated by playbackPositionStartParameter and wrap, so that the value stays within [0,1) (i.e. within wavetable later on)
-    float effectiveBufferPos = static_cast<float>(effectivePhase) * static_cast<float>(osc->fileBuffer.getNumSamples() - 1); //convert phase back to index within wavetable (-1 at the end to ensure that floating-point rounding won't let the variable take on out-of-range values!)
-    //^- see updateCurrentValues method in RegionLfo for some more details
+    //pitch shift
+    double previousBufferPosDelta = bufferPosDelta;
+    updateBufferPosDelta(); //sets bufferPosDelta to the target value
+    bufferPosDeltaIncrement = (bufferPosDelta - previousBufferPosDelta) * rampFactor;
+    bufferPosDelta = previousBufferPosDelta;
 
-    //pre-calculate volume of the next sample (for all channels)
-    double gainAdjustment = envelope.getNextEnvelopeSample() * levelParameter.getModulatedValue(); //= envelopeLevel * level (with all modulations)
+    //level
+    levelIncrement = (levelParameter.getModulatedValue() - currentLevel) * rampFactor;
 
-    //update filter position
-    filter.parameters->setCutOffFrequency(getSampleRate(), filterPositionParameter.getModulatedValue());
+    //playback position
+    latestPlaybackPositionStart = playbackPositionStartParameter.getModulatedValue();
+    latestPlaybackPositionInterval = playbackPositionIntervalParameter.getModulatedValue(); //note that playbackPositionIntervalParameter is a capped parameter that cannot become 0.0
+    evaluateBufferPosModulation(); //jumps to a new currentBufferPos if required
 
-    //calculate sample(s)
-    for (auto i = outputBuffer.getNumChannels() - 1; i >= 0; --i)
+    //filter position
+    filter.setCutoffFrequency(filterPositionParameter.getModulatedValue()); //only recalculates the coefficients if the value changed
+}
+void Voice::calculateReadPositions(int numSamples, int numFileSamples)
+{
+    //all positions are wrapped at numFileSamples - 1, because the last sample is equal to the first.
+    //the wrapping of the interval and the starting position is prepared once here, so that the loop below only needs a comparison per sample instead of two fmods.
+    double wrapLength = static_cast<double>(juce::jmax(1, numFileSamples - 1));
+    double intervalLength = latestPlaybackPositionInterval * wrapLength; //only the range [0, interval) of the buffer is played back. the interval is capped, so this cannot become 0.0
+    double startOffset = std::fmod(latestPlaybackPositionStart, 1.0) * wrapLength; //shift the starting position from 0 to the value stated by playbackPositionStartParameter
+    if (startOffset < 0.0)
     {
-        //auto currentSample = (osc->fileBuffer.getSample(i % osc->fileBuffer.getNumChannels(), (int)currentBufferPos)) * gainAdjustment;
-        auto currentSample = (osc->fileBuffer.getSample(i % osc->fileBuffer.getNumChannels(), static_cast<int>(effectiveBufferPos))) * gainAdjustment;
-        currentSample = filter.processSample(currentSample);
-        outputBuffer.addSample(i, sampleIndex, (float)currentSample);
+        startOffset += wrapLength;
     }
 
-    associatedLfo->advance();
+    if (currentBufferPos >= intervalLength) //may happen if the interval has just been shortened
+    {
+        currentBufferPos = std::fmod(currentBufferPos, intervalLength);
+    }
 
-    if (envelope.isIdle()) //has finished playing (including release). may also occur if the sample rate suddenly changed, but in theory, that shouldn't happen I think
+    double* positions = readPositions.get();
+    for (int i = 0; i < numSamples; ++i)
     {
-        //stop note
-        clearCurrentNote();
-        bufferPosDelta = 0.0;
-        currentState->playableChanged(false);
+        double pos = currentBufferPos + startOffset;
+        while (pos >= wrapLength) //normally at most once (only intervals > 1.0 may need more than one iteration)
+        {
+            pos -= wrapLength;
+        }
+        positions[i] = pos;
+
+        //advance
+        currentBufferPos += bufferPosDelta;
+        bufferPosDelta += bufferPosDeltaIncrement;
+        if (currentBufferPos >= intervalLength)
+        {
+            currentBufferPos -= intervalLength;
+        }
     }
+    jassert(currentBufferPos >= 0.0 && currentBufferPos < numFileSamples);
 }
 
 //==============================================================================
@@ -333,7 +562,7 @@ void Voice::transitionToState(VoiceStateIndex stateToTransitionTo)
             break;
 
         case VoiceStateIndex::noWavefile_noLfo:
-            if (osc != nullptr && osc->fileBuffer.getNumSamples() > 0)
+            if (osc != nullptr && osc->getNumSamples() > 0)
             {
                 if (associatedLfo != nullptr)
                 {
@@ -357,7 +586,7 @@ void Voice::transitionToState(VoiceStateIndex stateToTransitionTo)
             break;
 
         case VoiceStateIndex::noWavefile_Lfo:
-            if (osc != nullptr && osc->fileBuffer.getNumSamples() > 0)
+            if (osc != nullptr && osc->getNumSamples() > 0)
             {
                 if (associatedLfo == nullptr)
                 {
@@ -418,6 +647,91 @@ bool Voice::isPlaying()
     return currentStateIndex == VoiceStateIndex::playable_Lfo || currentStateIndex == VoiceStateIndex::playable_noLfo;
 }
 
+//==============================================================================
+void Voice::steal(bool retriggerAfterwards)
+{
+    retriggerAfterSteal.store(retriggerAfterwards);
+    beingStolen.store(true);
+    stealRequested.store(true);
+}
+bool Voice::isBeingStolen()
+{
+    return beingStolen.load();
+}
+bool Voice::isReleasing()
+{
+    return envelope.isReleasing();
+}
+float Voice::getCurrentGain()
+{
+    return currentGain.load(std::memory_order_relaxed);
+}
+juce::uint32 Voice::getNoteOnStamp()
+{
+    return noteOnStamp.load(std::memory_order_relaxed);
+}
+void Voice::setNoteOnStamp(juce::uint32 newNoteOnStamp)
+{
+    noteOnStamp.store(newNoteOnStamp, std::memory_order_relaxed);
+}
+
+void Voice::applyPendingSteal()
+{
+    if (!stealRequested.exchange(false))
+    {
+        return;
+    }
+
+    if (isPlaying())
+    {
+        stealRampSamplesRemaining = stealRampLength; //fade out during the next few sub-blocks (see renderWave)
+    }
+    else
+    {
+        //has already stopped on its own in the meantime -> nothing to fade out
+        beingStolen.store(false);
+        if (retriggerAfterSteal.exchange(false))
+        {
+            startNote(0, 1.0f, nullptr, 64); //the sound isn't used by this voice
+            signalRestartedToPool();
+        }
+        else
+        {
+            signalStoppedToPool(); //wasn't handed back to the pool when it stopped, because it was being stolen then
+        }
+    }
+}
+bool Voice::finishStealing()
+{
+    stealRampEnded = false;
+    beingStolen.store(false);
+    envelope.forceStop(); //the voice is silent at this point
+
+    if (retriggerAfterSteal.exchange(false))
+    {
+        startNote(0, 1.0f, nullptr, 64); //starts the envelope from scratch. the sound isn't used by this voice
+        signalRestartedToPool();
+        return true;
+    }
+
+    stopAfterEnvelopeEnded();
+    return false;
+}
+void Voice::signalStoppedToPool()
+{
+    if (pool != nullptr)
+    {
+        pool->voiceStopped(this); //makes the voice available to its region again
+    }
+}
+void Voice::signalRestartedToPool()
+{
+    if (pool != nullptr)
+    {
+        pool->voiceRestarted(this); //counts the voice as active again
+    }
+}
+
 //==============================================================================
 ModulatableMultiplicativeParameter<double>* Voice::getLevelParameter()
 {
@@ -499,11 +813,11 @@ double Voice::getBaseFilterPosition()
 
 void Voice::setFilterType(juce::dsp::StateVariableFilter::StateVariableFilterType newFilterType)
 {
-    filter.parameters->type = newFilterType;
+    filter.setType(newFilterType);
 }
 juce::dsp::StateVariableFilter::StateVariableFilterType Voice::getFilterType()
 {
-    return filter.parameters->type;
+    return filter.getType();
 }
 
 void Voice::updateBufferPosDelta()
@@ -536,26 +850,14 @@ void Voice::evaluateBufferPosModulation()
     double modulatedBufferPos = currentBufferPos;
     if (playbackPositionCurrentParameter.modulateValueIfUpdated(&modulatedBufferPos)) //true if it updated the value
     {
-        currentBufferPos = static_cast<float>(std::fmod(modulatedBufferPos, 1.0)) * static_cast<float>(osc->fileBuffer.getNumSamples() - 1); //subtracting -1 should *theoretically* not be necessary here bc it will be multiplied with a value within [0,1), *but* due to rounding, it would be possible that it takes on an out-of-range value! it shouldn't make a noticable difference sound-wise.
+        currentBufferPos = static_cast<float>(std::fmod(modulatedBufferPos, 1.0)) * static_cast<float>(osc->getNumSamples() - 1); //subtracting -1 should *theoretically* not be necessary here bc it will be multiplied with a value within [0,1), *but* due to rounding, it would be possible that it takes on an out-of-range value! it shouldn't make a noticable difference sound-wise.
         //^- see evaluateTablePosModulation method in RegionLfo for further notes
 
-        //don't advance; stick to the target phase!
+        //don't advance; stick to the target phase! (the buffer position is only advanced after the first sample of the sub-block has been read)
 
         envelope.noteOn(false, true); //restart envelope (from attack, not from delay) for a cleaner sound. ignored during release (otherwise, voices with long envelopes and relatively short update intervals that modulate their own playback position would play indefinitely!)
     }
-    else
-    {
-        //no need to adjust currentTablePos (it didn't change).
-
-        //advance
-        currentBufferPos += bufferPosDelta;
-        double latestPlaybackPosInterval = playbackPositionIntervalParameter.getModulatedValue();
-        if (currentBufferPos >= latestPlaybackPosInterval * static_cast<float>(osc->fileBuffer.getNumSamples() - 1)) //-1 because the last sample is equal to the first; multiplied with the phase interval because otherwise, there will be doubling!
-        {
-            currentBufferPos -= latestPlaybackPosInterval * static_cast<float>(osc->fileBuffer.getNumSamples() - 1);
-        }
-        jassert(currentBufferPos >= 0 && currentBufferPos < osc->fileBuffer.getNumSamples());
-    }
+    //else: no need to adjust currentTablePos (it didn't change).
 }
 
 void Voice::setPitchQuantisationMethod(PitchQuantisationMethod newPitchQuantisationMethod)
@@ -786,6 +1088,16 @@ PitchQuantisationMethod Voice::getPitchQuantisationMethod()
     return currentPitchQuantisationMethod;
 }
 
+void Voice::setInterpolationMethod(InterpolationMethod newInterpolationMethod)
+{
+    interpolationFuncPt = SamplePlaybackKernel::getInterpolationFunction(newInterpolationMethod); //throws if the method is unhandled
+    currentInterpolationMethod = newInterpolationMethod;
+}
+InterpolationMethod Voice::getInterpolationMethod()
+{
+    return currentInterpolationMethod;
+}
+
 double Voice::getQuantisedPitch_continuous()
 {
     return pitchShiftParameter.getModulatedValue(); //no special processing needed
@@ -1438,6 +1750,10 @@ void Voice::setLfo(RegionLfo* newAssociatedLfo)
     associatedLfo = newAssociatedLfo;
     currentState->associatedLfoChanged(associatedLfo);
 }
+RegionLfo* Voice::getLfo()
+{
+    return associatedLfo;
+}
 
 int Voice::getID()
 {
@@ -1472,6 +1788,7 @@ bool Voice::serialise(juce::XmlElement* xmlVoice)
     //bufferPos, bufferPosDelta: not needed
     xmlVoice->setAttribute("restartOnNoteOn", restartOnNoteOn);
     xmlVoice->setAttribute("currentPitchQuantisationMethod", static_cast<int>(currentPitchQuantisationMethod));
+    xmlVoice->setAttribute("currentInterpolationMethod", static_cast<int>(currentInterpolationMethod));
 
     //parameters
     xmlVoice->setAttribute("levelParameter_base", levelParameter.getBaseValue());
@@ -1479,7 +1796,7 @@ bool Voice::serialise(juce::XmlElement* xmlVoice)
     xmlVoice->setAttribute("playbackPositionStartParameter_base", playbackPositionStartParameter.getBaseValue());
     xmlVoice->setAttribute("playbackPositionIntervalParameter_base", playbackPositionIntervalParameter.getBaseValue());
     xmlVoice->setAttribute("filterPositionParameter_base", filterPositionParameter.getBaseValue());
-    xmlVoice->setAttribute("filterType", static_cast<int>(filter.parameters->type));
+    xmlVoice->setAttribute("filterType", static_cast<int>(filter.getType()));
 
     //envelope
     serialisationSuccessful = envelope.serialise(xmlVoice);
@@ -1499,6 +1816,7 @@ bool Voice::deserialise(juce::XmlElement* xmlVoice)
     //bufferPos, bufferPosDelta: not needed
     restartOnNoteOn = xmlVoice->getBoolAttribute("restartOnNoteOn", false);
     setPitchQuantisationMethod(static_cast<PitchQuantisationMethod>(xmlVoice->getIntAttribute("currentPitchQuantisationMethod", static_cast<int>(PitchQuantisationMethod::continuous))));
+    setInterpolationMethod(static_cast<InterpolationMethod>(xmlVoice->getIntAttribute("currentInterpolationMethod", static_cast<int>(InterpolationMethod::linear))));
 
     //parameters
     levelParameter.setBaseValue(xmlVoice->getDoubleAttribute("levelParameter_base", 0.25));
@@ -1506,7 +1824,7 @@ bool Voice::deserialise(juce::XmlElement* xmlVoice)
     playbackPositionIntervalParameter.setBaseValue(xmlVoice->getDoubleAttribute("playbackPositionIntervalParameter_base", 1.0));
     playbackPositionStartParameter.setBaseValue(xmlVoice->getDoubleAttribute("playbackPositionStartParameter_base", 0.0));
     filterPositionParameter.setBaseValue(xmlVoice->getDoubleAttribute("filterPositionParameter_base", 22050.0));
-    filter.parameters->type = static_cast<juce::dsp::StateVariableFilter::StateVariableFilterType>(xmlVoice->getIntAttribute("filterType", 0));
+    filter.setType(static_cast<juce::dsp::StateVariableFilter::StateVariableFilterType>(xmlVoice->getIntAttribute("filterType", 0)));
 
     //envelope
     deserialisationSuccessful = envelope.deserialise(xmlVoice);
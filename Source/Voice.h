@@ -23,10 +23,15 @@ class VoiceState_Playable_Lfo;
 #include "VoiceStateIndex.h"
 
 #include "SamplerOscillator.h"
+#include "SnapshotExchange.h"
 #include "DahdsrEnvelope.h"
 #include "ModulatableParameter.h"
 #include "RegionLfo.h"
 #include "PitchQuantisationMethod.h"
+#include "InterpolationMethod.h"
+#include "SamplePlaybackKernel.h"
+#include "VoiceFilter.h"
+class VoicePool;
 
 
 //==============================================================================
@@ -37,14 +42,15 @@ struct Voice : public juce::SynthesiserVoice
 public:
     Voice();
     Voice(int regionID);
-    Voice(juce::AudioSampleBuffer buffer, int origSampleRate, int regionID);
+    Voice(SampleStore::Sample::Ptr sample, int regionID);
 
     ~Voice() override;
 
     //==============================================================================
     void prepare(const juce::dsp::ProcessSpec& spec);
 
-    void setOsc(juce::AudioSampleBuffer buffer, int origSampleRate);
+    void setOsc(SampleStore::Sample::Ptr sample); //the new file is picked up by the audio thread at the beginning of the next block. nullptr removes the file
+    void setOsc(StreamingAudioFile::Ptr stream); //same as above, but for files that are streamed from disk
 
     bool canPlaySound(juce::SynthesiserSound* sound) override;
 
@@ -67,14 +73,23 @@ public:
     void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override;
 
     void renderNextBlock_empty();
-    void renderNextBlock_onlyLfo();
-    void renderNextBlock_wave(juce::AudioSampleBuffer& outputBuffer, int sampleIndex);
-    void renderNextBlock_waveAndLfo(juce::AudioSampleBuffer& outputBuffer, int sampleIndex);
+    void renderNextBlock_wave(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+    int renderWave(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+    void stopAfterEnvelopeEnded();
 
     //==============================================================================
     void transitionToState(VoiceStateIndex stateToTransitionTo);
     bool isPlaying();
 
+    //==============================================================================
+    //voice stealing (see VoicePool)
+    void steal(bool retriggerAfterwards); //fades the voice out within a few milliseconds. afterwards, it either stops or starts again. picked up by the audio thread at the beginning of the next block
+    bool isBeingStolen();
+    bool isReleasing();
+    float getCurrentGain(); //latest envelope * level value. approximates how loud the voice currently is
+    juce::uint32 getNoteOnStamp();
+    void setNoteOnStamp(juce::uint32 newNoteOnStamp);
+
     //==============================================================================
     ModulatableMultiplicativeParameter<double>* getLevelParameter();
     void setBaseLevel(double newLevel);
@@ -107,11 +122,16 @@ public:
     void updateBufferPosDelta_NotPlayable();
     void updateBufferPosDelta_Playable();
 
+    void evaluateControlRateValues(int numSamples);
     void evaluateBufferPosModulation();
+    void calculateReadPositions(int numSamples, int numFileSamples);
 
     void setPitchQuantisationMethod(PitchQuantisationMethod newPitchQuantisationMethod);
     PitchQuantisationMethod getPitchQuantisationMethod();
 
+    void setInterpolationMethod(InterpolationMethod newInterpolationMethod);
+    InterpolationMethod getInterpolationMethod();
+
     double getQuantisedPitch_continuous();
     double getQuantisedPitch_semitones();
     double getQuantisedPitch_scale();
@@ -160,6 +180,7 @@ public:
     void setPitchQuantisationScale_perfectOctave();
 
     void setLfo(RegionLfo* newAssociatedLfo);
+    RegionLfo* getLfo(); //the voice only reads the LFO's output. the LFO itself is advanced by the AudioEngine
 
     int getID();
     void setID(int newID);
@@ -184,6 +205,12 @@ private:
     int ID = -1;
 
     double currentBufferPos = 0.0, bufferPosDelta = 0.0;
+    double bufferPosDeltaIncrement = 0.0; //bufferPosDelta is evaluated at control rate and ramped linearly at audio rate
+
+    //modulated values that are evaluated once per sub-block (see evaluateControlRateValues)
+    double currentLevel = 0.0, levelIncrement = 0.0; //ramped linearly at audio rate
+    double latestPlaybackPositionStart = 0.0;
+    double latestPlaybackPositionInterval = 1.0;
     bool restartOnNoteOn = false;
 
     ModulatableMultiplicativeParameter<double> levelParameter;
@@ -195,14 +222,59 @@ private:
     double (Voice::* pitchQuantisationFuncPt)() = nullptr;
     int pitchQuantisationScale[12]; //for each semitone in an octave (-> input index), maps to a note on a scale
 
+    InterpolationMethod currentInterpolationMethod = InterpolationMethod::linear;
+    SamplePlaybackKernel::interpolationFuncPt interpolationFuncPt = nullptr;
+
+    //scratch memory for rendering (allocated in prepare, so that no allocations happen on the audio thread)
+    static const int defaultPlaybackScratchSize = 512; //used if the maximum block size is unknown
+    int playbackScratchSize = 0;
+    juce::AudioBuffer<float> playbackScratch; //one channel per used file channel
+    juce::HeapBlock<float> playbackGains; //envelope * level for each sample
+    juce::HeapBlock<double> readPositions; //fractional read position within the file buffer for each sample
+
+    //streamed files are read into a window around the read positions first, which the interpolation kernel then reads from
+    static const int streamWindowSize = 8192; //maximum span of read positions (in samples) that is covered by one window
+    static const int streamWindowMargin = SamplePlaybackKernel::sincNumTaps / 2; //neighbouring samples needed by the interpolation on either side of the span
+    juce::HeapBlock<float> streamWindow;
+    void readStreamedSamples(int numUsedChannels, int numSamples);
+
+    //at playback speeds above 1, the sample's mip-map is read instead, so that high transpositions don't alias
+    juce::HeapBlock<float> mipScratch; //upper of the two crossfaded levels
+    juce::HeapBlock<double> mipReadPositions; //readPositions scaled to the length of a level
+    void readMipMappedSamples(int numUsedChannels, int numFileSamples, int numSamples, double playbackSpeed);
+
     ModulatableAdditiveParameter<double> playbackPositionStartParameter;
     ModulatableMultiplicativeParameterLowerCap<double> playbackPositionIntervalParameter;
     ModulatableAdditiveParameter<double> playbackPositionCurrentParameter;
 
     ModulatableMultiplicativeParameterLowerCap<double> filterPositionParameter;
-    juce::dsp::StateVariableFilter::Filter<double> filter;
-
-    SamplerOscillator* osc;
+    VoiceFilter filter; //one state per channel, processes whole blocks
+
+    //voice stealing
+    static const double stealRampSeconds; //length of the fade-out of stolen voices
+    int stealRampLength = 1; //in samples (set in prepare)
+    int stealRampSamplesRemaining = 0; //only accessed by the audio thread (as is stealRampEnded)
+    bool stealRampEnded = false;
+    std::atomic<bool> stealRequested { false }; //picked up by the audio thread at the beginning of the next block
+    std::atomic<bool> retriggerAfterSteal { false }; //cleared by stopNote, so that a voice that is stopped during its fade-out doesn't start again
+    std::atomic<bool> beingStolen { false };
+    std::atomic<float> currentGain { 0.0f };
+    std::atomic<juce::uint32> noteOnStamp { 0 }; //assigned by the VoicePool whenever the voice is started
+    void applyPendingSteal();
+
+    //voice pool bookkeeping. the voice tells its pool whenever it stops or restarts on its own (see VoicePool::voiceStopped)
+    friend class VoicePool;
+    VoicePool* pool = nullptr; //set by VoicePool::addVoice
+    bool isPooled = false; //only accessed while holding the pool's lock (as are the following members)
+    int freeListIndex = -1; //index within the free list of the voice's region, or -1 if the voice isn't idle
+    bool isCountedAsActive = false;
+    void signalStoppedToPool();
+    void signalRestartedToPool();
+    bool finishStealing(); //returns true if the voice has been restarted
+
+    SamplerOscillator::Ptr osc; //only replaced by applyPendingOsc
+    SnapshotExchange<SamplerOscillator> oscExchange;
+    void applyPendingOsc();
 
     RegionLfo* associatedLfo = nullptr;
 
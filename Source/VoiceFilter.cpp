@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    VoiceFilter.cpp
+    Created: 17 Oct 2026 11:03:27am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "VoiceFilter.h"
+
+const double VoiceFilter::minCutoffFrequency = 20.0; //same as the lower cap of the filter position parameter
+const double VoiceFilter::maxCutoffFrequency = 22050.0;
+
+VoiceFilter::VoiceFilter()
+{
+    prepare(sampleRate, 2); //sample rate will be set again later during preparation
+}
+VoiceFilter::~VoiceFilter()
+{
+    s1.free();
+    s2.free();
+}
+
+void VoiceFilter::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = juce::jmax(1, newNumChannels);
+
+    //the coefficient approaches infinity at the nyquist frequency, so the table has to stop somewhat below it
+    currentMaxCutoffFrequency = juce::jmin(maxCutoffFrequency, 0.49 * sampleRate);
+    double pi_over_sampleRate = juce::MathConstants<double>::pi / sampleRate;
+    gApprox.initialise([pi_over_sampleRate](double cutoff) { return std::tan(cutoff * pi_over_sampleRate); },
+                       minCutoffFrequency, currentMaxCutoffFrequency, gApproxNumPoints);
+
+    s1.allocate(numChannels, true);
+    s2.allocate(numChannels, true);
+
+    //force re-calculation of the coefficients (the sample rate might have changed)
+    double previousCutoffFrequency = cutoffFrequency;
+    cutoffFrequency = -1.0;
+    setCutoffFrequency((previousCutoffFrequency > 0.0) ? previousCutoffFrequency : currentMaxCutoffFrequency);
+}
+void VoiceFilter::reset()
+{
+    juce::FloatVectorOperations::clear(s1.get(), numChannels);
+    juce::FloatVectorOperations::clear(s2.get(), numChannels);
+}
+
+void VoiceFilter::setType(FilterType newType)
+{
+    type = newType;
+}
+VoiceFilter::FilterType VoiceFilter::getType()
+{
+    return type;
+}
+
+void VoiceFilter::setCutoffFrequency(double newCutoffFrequency)
+{
+    if (newCutoffFrequency == cutoffFrequency)
+    {
+        return; //nothing to recalculate. this is by far the most common case, because the filter position only changes when one of its modulators updates.
+    }
+
+    cutoffFrequency = newCutoffFrequency;
+    updateCoefficients();
+}
+double VoiceFilter::getCutoffFrequency()
+{
+    return cutoffFrequency;
+}
+
+void VoiceFilter::updateCoefficients()
+{
+    double clampedCutoff = juce::jlimit(minCutoffFrequency, currentMaxCutoffFrequency, cutoffFrequency);
+    g = gApprox.processSampleUnchecked(clampedCutoff);
+    h = 1.0 / (1.0 + R2 * g + g * g);
+}
+
+void VoiceFilter::processBlock(float* samples, int channel, int numSamples)
+{
+    jassert(channel >= 0 && channel < numChannels);
+
+    //work on local copies of the states and coefficients so that they can stay in registers
+    double state1 = s1[channel], state2 = s2[channel];
+    const double localG = g, gPlusR2 = g + R2, localH = h;
+
+    //the type is checked once per block instead of once per sample
+    switch (type)
+    {
+    case FilterType::lowPass:
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double yHP = localH * (static_cast<double>(samples[i]) - state1 * gPlusR2 - state2);
+            double yBP = yHP * localG + state1;
+            state1 = yHP * localG + yBP;
+            double yLP = yBP * localG + state2;
+            state2 = yBP * localG + yLP;
+            samples[i] = static_cast<float>(yLP);
+        }
+        break;
+
+    case FilterType::bandPass:
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double yHP = localH * (static_cast<double>(samples[i]) - state1 * gPlusR2 - state2);
+            double yBP = yHP * localG + state1;
+            state1 = yHP * localG + yBP;
+            double yLP = yBP * localG + state2;
+            state2 = yBP * localG + yLP;
+            samples[i] = static_cast<float>(yBP);
+        }
+        break;
+
+    case FilterType::highPass:
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double yHP = localH * (static_cast<double>(samples[i]) - state1 * gPlusR2 - state2);
+            double yBP = yHP * localG + state1;
+            state1 = yHP * localG + yBP;
+            double yLP = yBP * localG + state2;
+            state2 = yBP * localG + yLP;
+            samples[i] = static_cast<float>(yHP);
+        }
+        break;
+
+    default:
+        throw std::exception("unhandled filter type");
+    }
+
+    //snap to zero (avoids denormals once the input has become silent)
+    s1[channel] = (std::abs(state1) < 1.0e-8) ? 0.0 : state1;
+    s2[channel] = (std::abs(state2) < 1.0e-8) ? 0.0 : state2;
+}
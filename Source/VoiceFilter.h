@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    VoiceFilter.h
+    Created: 17 Oct 2026 11:03:27am
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/// <summary>
+/// TPT state variable filter (12dB/oct) that processes whole blocks per channel.
+/// The filter coefficient g = tan(pi * cutoff / sampleRate) is read from a lookup table that is rebuilt whenever the sample rate changes,
+/// and the coefficients are only recalculated if the cutoff frequency actually changed.
+/// </summary>
+class VoiceFilter
+{
+public:
+    typedef juce::dsp::StateVariableFilter::StateVariableFilterType FilterType; //kept for compatibility with the filter type choice and old save files
+
+    VoiceFilter();
+    ~VoiceFilter();
+
+    void prepare(double newSampleRate, int newNumChannels);
+    void reset();
+
+    void setType(FilterType newType);
+    FilterType getType();
+
+    void setCutoffFrequency(double newCutoffFrequency);
+    double getCutoffFrequency();
+
+    void processBlock(float* samples, int channel, int numSamples);
+
+    static const double minCutoffFrequency;
+    static const double maxCutoffFrequency;
+
+private:
+    void updateCoefficients();
+
+    FilterType type = FilterType::lowPass;
+    double sampleRate = 48000.0;
+    int numChannels = 0;
+
+    juce::dsp::LookupTableTransform<double> gApprox; //pre-calculates tan(pi * cutoff / sampleRate) for cutoffs within [minCutoffFrequency, maximum cutoff of the current sample rate]
+    double currentMaxCutoffFrequency = maxCutoffFrequency;
+    static const int gApproxNumPoints = 4096;
+
+    double cutoffFrequency = -1.0; //-1.0 -> coefficients haven't been calculated yet
+    double g = 0.0, R2 = juce::MathConstants<double>::sqrt2, h = 0.0; //R2 = 1/Q with Q = 1/sqrt(2) (same resonance as before)
+
+    juce::HeapBlock<double> s1, s2; //integrator states, one per channel
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceFilter)
+};
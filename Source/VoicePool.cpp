@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+    VoicePool.cpp
+    Created: 17 Oct 2026 8:04:52pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#include "VoicePool.h"
+
+//constants
+const int VoicePool::unlimitedVoices = 0;
+
+
+VoicePool::VoicePool()
+{
+    setStealingPolicy(currentStealingPolicy);
+}
+VoicePool::~VoicePool()
+{
+    clear();
+}
+
+void VoicePool::addVoice(Voice* voice)
+{
+    int regionID = voice->getID();
+    jassert(regionID >= 0);
+
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    auto* region = getOrCreateRegionVoices(regionID);
+    region->voices.add(voice);
+    if (region->capacity < region->voices.size())
+    {
+        region->capacity = region->voices.size();
+        region->freeVoices.realloc(region->capacity); //keeps the current free voices
+    }
+    allVoices.add(voice);
+
+    voice->pool = this;
+    voice->isPooled = true;
+    voice->freeListIndex = -1;
+    voice->isCountedAsActive = false;
+    if (voice->isPlaying())
+    {
+        setCountedAsActive(voice, true);
+    }
+    else
+    {
+        pushFreeVoice(voice);
+    }
+}
+void VoicePool::removeVoice(Voice* voice)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    removeFreeVoice(voice);
+    setCountedAsActive(voice, false);
+    voice->isPooled = false; //the voice may still call voiceStopped until it has been removed from the synth
+
+    if (auto* region = voicesOfRegion[voice->getID()])
+    {
+        region->voices.removeFirstMatchingValue(voice);
+    }
+    allVoices.removeFirstMatchingValue(voice);
+}
+void VoicePool::changeRegionID(int regionID, int newRegionID)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    getOrCreateRegionVoices(juce::jmax(regionID, newRegionID)); //makes sure that both indices exist
+    voicesOfRegion.swap(regionID, newRegionID); //the new ID isn't taken, so its list is empty
+
+    //changed while holding the lock, so that voices which stop meanwhile are handed back to the right region
+    for (auto itVoice = voicesOfRegion[newRegionID]->voices.begin(); itVoice != voicesOfRegion[newRegionID]->voices.end(); ++itVoice)
+    {
+        (*itVoice)->setID(newRegionID);
+    }
+}
+void VoicePool::clear()
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    for (auto itVoice = allVoices.begin(); itVoice != allVoices.end(); ++itVoice)
+    {
+        (*itVoice)->isPooled = false;
+        (*itVoice)->freeListIndex = -1;
+        (*itVoice)->isCountedAsActive = false;
+    }
+    voicesOfRegion.clear(true);
+    allVoices.clear();
+    numActiveVoices.store(0);
+}
+
+Voice* VoicePool::startVoice(int regionID, juce::SynthesiserSound* sound)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+
+    auto* region = voicesOfRegion[regionID];
+    if (region == nullptr || region->voices.size() == 0)
+    {
+        return nullptr;
+    }
+
+    //prefer an idle voice of the region
+    Voice* voice = popFreeVoice(region);
+
+    if (voice != nullptr)
+    {
+        //keep within the global budget by quickly fading out another voice
+        int limit = maxActiveVoices.load();
+        if (limit != unlimitedVoices && numActiveVoices.load() >= limit)
+        {
+            Voice* victim = (this->*findVictimFuncPt)(allVoices);
+            if (victim != nullptr)
+            {
+                DBG("global voice limit reached -> stealing a voice of region " + juce::String(victim->getID()));
+                victim->steal(false);
+                setCountedAsActive(victim, false);
+            }
+        }
+
+        voice->startNote(0, 1.0f, sound, 64);
+        setCountedAsActive(voice, true);
+    }
+    else
+    {
+        //all of the region's voices are busy -> steal one of them and restart it once it has faded out
+        voice = (this->*findVictimFuncPt)(region->voices);
+        if (voice == nullptr)
+        {
+            voice = region->voices.getFirst(); //all of them are being stolen already -> make one of them start again after its fade-out
+        }
+        voice->steal(true);
+        setCountedAsActive(voice, false); //counted again once it has restarted (see voiceRestarted)
+    }
+
+    voice->setNoteOnStamp(++noteOnCounter);
+    return voice;
+}
+int VoicePool::getNumActiveVoices()
+{
+    return numActiveVoices.load();
+}
+
+void VoicePool::voiceStopped(Voice* voice)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    if (!voice->isPooled)
+    {
+        return; //has been removed in the meantime
+    }
+
+    setCountedAsActive(voice, false);
+    if (!voice->isBeingStolen()) //otherwise, it's handed back once its pending steal has been handled (see Voice::applyPendingSteal), since it might restart
+    {
+        pushFreeVoice(voice);
+    }
+}
+void VoicePool::voiceRestarted(Voice* voice)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+    if (!voice->isPooled)
+    {
+        return;
+    }
+
+    removeFreeVoice(voice);
+    setCountedAsActive(voice, true);
+}
+
+VoicePool::RegionVoices* VoicePool::getOrCreateRegionVoices(int regionID)
+{
+    while (voicesOfRegion.size() <= regionID)
+    {
+        voicesOfRegion.add(new RegionVoices());
+    }
+    return voicesOfRegion[regionID];
+}
+void VoicePool::pushFreeVoice(Voice* voice)
+{
+    auto* region = voicesOfRegion[voice->getID()];
+    if (region == nullptr || voice->freeListIndex >= 0)
+    {
+        return; //already idle
+    }
+
+    jassert(region->numFreeVoices < region->capacity);
+    voice->freeListIndex = region->numFreeVoices;
+    region->freeVoices[region->numFreeVoices++] = voice;
+}
+void VoicePool::removeFreeVoice(Voice* voice)
+{
+    auto* region = voicesOfRegion[voice->getID()];
+    if (region == nullptr || voice->freeListIndex < 0)
+    {
+        return; //not idle
+    }
+
+    //move the last free voice into the gap
+    Voice* lastFreeVoice = region->freeVoices[--region->numFreeVoices];
+    region->freeVoices[voice->freeListIndex] = lastFreeVoice;
+    lastFreeVoice->freeListIndex = voice->freeListIndex;
+    voice->freeListIndex = -1;
+}
+Voice* VoicePool::popFreeVoice(RegionVoices* region)
+{
+    if (region->numFreeVoices == 0)
+    {
+        return nullptr;
+    }
+
+    Voice* voice = region->freeVoices[region->numFreeVoices - 1];
+    removeFreeVoice(voice);
+    return voice;
+}
+void VoicePool::setCountedAsActive(Voice* voice, bool shouldBeCounted)
+{
+    if (voice->isCountedAsActive != shouldBeCounted)
+    {
+        voice->isCountedAsActive = shouldBeCounted;
+        numActiveVoices.fetch_add(shouldBeCounted ? 1 : -1);
+    }
+}
+
+int VoicePool::getMaxActiveVoices()
+{
+    return maxActiveVoices.load();
+}
+void VoicePool::setMaxActiveVoices(int newMaxActiveVoices)
+{
+    maxActiveVoices.store(juce::jmax(unlimitedVoices, newMaxActiveVoices));
+}
+
+VoiceStealingPolicy VoicePool::getStealingPolicy()
+{
+    return currentStealingPolicy;
+}
+void VoicePool::setStealingPolicy(VoiceStealingPolicy newStealingPolicy)
+{
+    const juce::SpinLock::ScopedLockType sl(poolLock);
+
+    switch (newStealingPolicy)
+    {
+    case VoiceStealingPolicy::oldest:
+        findVictimFuncPt = &VoicePool::findVictim_oldest;
+        break;
+
+    case VoiceStealingPolicy::quietest:
+        findVictimFuncPt = &VoicePool::findVictim_quietest;
+        break;
+
+    case VoiceStealingPolicy::releasingFirst:
+        findVictimFuncPt = &VoicePool::findVictim_releasingFirst;
+        break;
+
+    default:
+        throw std::exception("unhandled voice stealing policy");
+    }
+
+    currentStealingPolicy = newStealingPolicy; //only once the policy is known to be valid
+}
+
+bool VoicePool::canBeStolen(Voice* voice)
+{
+    return voice->isPlaying() && !voice->isBeingStolen();
+}
+Voice* VoicePool::findVictim_oldest(const juce::Array<Voice*>& candidates)
+{
+    Voice* victim = nullptr;
+    juce::uint32 highestAge = 0;
+
+    for (auto* v : candidates)
+    {
+        if (!canBeStolen(v))
+        {
+            continue;
+        }
+
+        juce::uint32 age = noteOnCounter - v->getNoteOnStamp(); //unsigned difference -> handles wrap-around
+        if (victim == nullptr || age > highestAge)
+        {
+            victim = v;
+            highestAge = age;
+        }
+    }
+
+    return victim;
+}
+Voice* VoicePool::findVictim_quietest(const juce::Array<Voice*>& candidates)
+{
+    Voice* victim = nullptr;
+    float lowestGain = 0.0f;
+
+    for (auto* v : candidates)
+    {
+        if (!canBeStolen(v))
+        {
+            continue;
+        }
+
+        float gain = v->getCurrentGain();
+        if (victim == nullptr || gain < lowestGain)
+        {
+            victim = v;
+            lowestGain = gain;
+        }
+    }
+
+    return victim;
+}
+Voice* VoicePool::findVictim_releasingFirst(const juce::Array<Voice*>& candidates)
+{
+    Voice* victim = nullptr;
+    juce::uint32 highestAge = 0;
+
+    for (auto* v : candidates)
+    {
+        if (!canBeStolen(v) || !v->isReleasing())
+        {
+            continue;
+        }
+
+        juce::uint32 age = noteOnCounter - v->getNoteOnStamp();
+        if (victim == nullptr || age > highestAge)
+        {
+            victim = v;
+            highestAge = age;
+        }
+    }
+
+    if (victim == nullptr)
+    {
+        return findVictim_oldest(candidates); //no voice is releasing
+    }
+    return victim;
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    VoicePool.h
+    Created: 17 Oct 2026 8:04:52pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Voice.h"
+#include "VoiceStealingPolicy.h"
+
+/// <summary>
+/// Decides which voice plays when a region starts, and keeps the number of sounding voices within a budget.
+/// Every region owns a fixed set of voices (its polyphony) that are allocated in advance. They can't be handed to other regions, because they carry the region's parameters and modulations.
+/// When a region starts, one of its idle voices is used. If all of them are busy, one of them is stolen (chosen by the stealing policy), faded out quickly and restarted.
+/// If the total number of sounding voices has reached the global limit, another voice is stolen and faded out as well, so that large presets stay within a fixed CPU budget.
+/// Every region keeps a free list of its idle voices, and the pool keeps count of the active voices, so that starting a voice takes constant time
+/// (only stealing needs to search for a victim). Voices hand themselves back to the pool when they stop (see voiceStopped).
+/// Voices are added and removed on the message thread. startVoice may also be called from the MIDI (audio) thread and never allocates.
+/// </summary>
+class VoicePool
+{
+public:
+    VoicePool();
+    ~VoicePool();
+
+    void addVoice(Voice* voice); //must be called before the voice is added to the synth
+    void removeVoice(Voice* voice); //must be called before the voice is removed from the synth
+    void changeRegionID(int regionID, int newRegionID); //also changes the IDs of the region's voices
+    void clear();
+
+    /// <summary>
+    /// Starts one of the region's voices, stealing one if necessary.
+    /// </summary>
+    /// <returns>The voice that has been started, or nullptr if the region doesn't have any voices</returns>
+    Voice* startVoice(int regionID, juce::SynthesiserSound* sound);
+    int getNumActiveVoices(); //voices that are sounding and aren't being stolen
+
+    void voiceStopped(Voice* voice); //called by the voice (on any thread) when it has stopped playing
+    void voiceRestarted(Voice* voice); //called by a stolen voice (on the audio thread) when it starts again after its fade-out
+
+    int getMaxActiveVoices();
+    void setMaxActiveVoices(int newMaxActiveVoices); //0: unlimited
+
+    VoiceStealingPolicy getStealingPolicy();
+    void setStealingPolicy(VoiceStealingPolicy newStealingPolicy);
+
+    static const int unlimitedVoices;
+
+private:
+    struct RegionVoices
+    {
+        juce::Array<Voice*> voices;
+        juce::HeapBlock<Voice*> freeVoices; //stack of idle voices. each voice knows its index within the stack (Voice::freeListIndex)
+        int numFreeVoices = 0;
+        int capacity = 0; //reserved for all of the region's voices, so that handing voices back never allocates
+    };
+    juce::OwnedArray<RegionVoices> voicesOfRegion; //index: region ID
+    juce::Array<Voice*> allVoices;
+    juce::SpinLock poolLock; //only held briefly. the arrays above are only resized on the message thread
+
+    juce::uint32 noteOnCounter = 0; //incremented whenever a voice starts. used to find the oldest voice
+    std::atomic<int> maxActiveVoices { 0 };
+    std::atomic<int> numActiveVoices { 0 }; //voices that are sounding and aren't being stolen. only changed while holding poolLock
+
+    VoiceStealingPolicy currentStealingPolicy = VoiceStealingPolicy::oldest;
+    Voice* (VoicePool::* findVictimFuncPt)(const juce::Array<Voice*>& candidates) = nullptr;
+    Voice* findVictim_oldest(const juce::Array<Voice*>& candidates);
+    Voice* findVictim_quietest(const juce::Array<Voice*>& candidates);
+    Voice* findVictim_releasingFirst(const juce::Array<Voice*>& candidates);
+    bool canBeStolen(Voice* voice);
+
+    //free lists and active count. must be called while holding poolLock
+    RegionVoices* getOrCreateRegionVoices(int regionID);
+    void pushFreeVoice(Voice* voice);
+    void removeFreeVoice(Voice* voice);
+    Voice* popFreeVoice(RegionVoices* region); //nullptr if all of the region's voices are busy
+    void setCountedAsActive(Voice* voice, bool shouldBeCounted);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoicePool)
+};
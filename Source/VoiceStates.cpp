@@ -48,7 +48,7 @@ void VoiceState_Unprepared::associatedLfoChanged(RegionLfo* newAssociatedLfo)
     //not prepared yet -> do nothing
 }
 
-void VoiceState_Unprepared::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_Unprepared::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     voice.renderNextBlock_empty(); //no sound, no LFO
 }
@@ -97,7 +97,7 @@ void VoiceState_NoWavefile_NoLfo::associatedLfoChanged(RegionLfo* newAssociatedL
     }
 }
 
-void VoiceState_NoWavefile_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_NoWavefile_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     voice.renderNextBlock_empty(); //no sound, no LFO
 }
@@ -146,11 +146,9 @@ void VoiceState_NoWavefile_Lfo::associatedLfoChanged(RegionLfo* newAssociatedLfo
     }
 }
 
-void VoiceState_NoWavefile_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_NoWavefile_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    //voice.renderNextBlock_onlyLfo(); //no sound, only LFO
-    //^- actually, this would make the LFO play even when no note has been pressed for some reason...
-    voice.renderNextBlock_empty();
+    voice.renderNextBlock_empty(); //no sound. (the LFO is advanced by the AudioEngine, but only while a voice of its region is playing)
 }
 
 void VoiceState_NoWavefile_Lfo::updateBufferPosDelta()
@@ -200,7 +198,7 @@ void VoiceState_Stopped_NoLfo::associatedLfoChanged(RegionLfo* newAssociatedLfo)
     }
 }
 
-void VoiceState_Stopped_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_Stopped_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     voice.renderNextBlock_empty(); //no sound, no LFO
 }
@@ -252,7 +250,7 @@ void VoiceState_Stopped_Lfo::associatedLfoChanged(RegionLfo* newAssociatedLfo)
     }
 }
 
-void VoiceState_Stopped_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_Stopped_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     voice.renderNextBlock_empty(); //no sound, no LFO (the LFO may be set, but the voice has stopped, so it shouldn't advance!)
 }
@@ -304,9 +302,9 @@ void VoiceState_Playable_NoLfo::associatedLfoChanged(RegionLfo* newAssociatedLfo
     }
 }
 
-void VoiceState_Playable_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_Playable_NoLfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    voice.renderNextBlock_wave(outputBuffer, sampleIndex); //sound, no LFO
+    voice.renderNextBlock_wave(outputBuffer, startSample, numSamples); //sound, no LFO
 }
 
 void VoiceState_Playable_NoLfo::updateBufferPosDelta()
@@ -356,9 +354,9 @@ void VoiceState_Playable_Lfo::associatedLfoChanged(RegionLfo* newAssociatedLfo)
     }
 }
 
-void VoiceState_Playable_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex)
+void VoiceState_Playable_Lfo::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    voice.renderNextBlock_waveAndLfo(outputBuffer, sampleIndex); //sound + LFO
+    voice.renderNextBlock_wave(outputBuffer, startSample, numSamples); //sound. the voice only reads the LFO, which is advanced once per sub-block by the AudioEngine (no matter how many voices of the region are playing)
 }
 
 void VoiceState_Playable_Lfo::updateBufferPosDelta()
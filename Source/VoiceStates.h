@@ -26,7 +26,7 @@ public:
     virtual void playableChanged(bool playable) = 0; //true if bufferPosDelta > 0.0, otherwise false
     virtual void associatedLfoChanged(RegionLfo* newAssociatedLfo) = 0;
 
-    virtual void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) = 0; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called. saves several if cases each sample
+    virtual void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) = 0; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called. saves several if cases each block
 
     virtual void updateBufferPosDelta() = 0; //chooses whether bufferPosDelta is set to 0.0 (when not playable) or calculated normally. saves 1 if case per sample
 
@@ -45,7 +45,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -60,7 +60,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -75,7 +75,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -90,7 +90,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -105,7 +105,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -120,7 +120,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
@@ -135,7 +135,7 @@ public:
     void playableChanged(bool playable) override; //true if bufferPosDelta > 0.0, otherwise false
     void associatedLfoChanged(RegionLfo* newAssociatedLfo) override;
 
-    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int sampleIndex) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
+    void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override; //chooses one of the simplified (normally unsafe) renderNextBlock methods in voice that should be called
 
     void updateBufferPosDelta() override;
 };
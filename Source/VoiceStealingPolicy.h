@@ -0,0 +1,18 @@
+/*
+  ==============================================================================
+
+    VoiceStealingPolicy.h
+    Created: 17 Oct 2026 8:04:52pm
+    Author:  Aaron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+enum class VoiceStealingPolicy : int
+{
+    oldest = 0, //steals the voice that has been started the longest time ago
+    quietest, //steals the voice with the lowest current gain (envelope * level)
+    releasingFirst //steals the oldest voice that is already releasing, or the oldest voice if none are
+};